@@ -8,8 +8,27 @@
 #define ERDOS_BACKTRACK_SOLVER_H
 
 #include <stdbool.h>
+#include <stdatomic.h>
 #include "types.h"
 #include "subset_sum_manager.h"
+#include "search_bounds.h"
+#include "nogood_cache.h"
+
+// ============================================================================
+// Константы
+// ============================================================================
+
+// Наибольший размер множества, проверяемого отсортированными суммами
+// в памяти (2^21 сумм, 16 МБ)
+#define B_SEQUENCE_SORTED_MAX 20
+
+// Наибольший размер множества для быстрой проверки: после
+// B_SEQUENCE_SORTED_MAX - внешнее слияние прогонов по 2^B_SEQUENCE_SORTED_MAX
+// сумм (не больше 16 прогонов)
+#define B_SEQUENCE_IN_MEMORY_MAX 24
+
+// Узлов между проверками ограничения времени (SolverConfig.time_limit_sec)
+#define BUDGET_TIME_SLICE (1ULL << 18)
 
 // ============================================================================
 // Callback типы
@@ -24,14 +43,45 @@ typedef void (*SolutionCallback)(uint32_t n, value_t max_value,
 
 /**
  * Callback для прогресса
- * Вызывается периодически для отчета о прогрессе
+ * Вызывается периодически вместо стандартного вывода прогресса
  */
 typedef void (*ProgressCallback)(const SearchStats *stats, void *user_data);
 
+/**
+ * Callback для оптимальных множеств (режим всех оптимальных)
+ * Вызывается для каждого множества с текущим лучшим максимумом; множества
+ * с прежним, большим максимумом после появления лучшего не оптимальны.
+ */
+typedef void (*OptimalSetCallback)(uint32_t n, const NumberSet *set, void *user_data);
+
 // ============================================================================
 // Структура решателя
 // ============================================================================
 
+/**
+ * Кадр явного стека поиска (один на позицию в множестве)
+ */
+typedef struct {
+    value_t next_candidate;        // Наименьший еще не рассмотренный кандидат
+    uint64_t nogood_key;           // Ключ кеша тупиков (0 - узел не записывается)
+    uint32_t solutions_at_entry;   // Решений найдено до входа в узел
+} SearchFrame;
+
+/**
+ * Явный стек поиска
+ * Менеджер содержит элементы позиций 0..depth-1, frames[depth] - перебор
+ * текущего узла. Вместе с менеджером это полное состояние поиска:
+ * его можно приостановить в любом узле и продолжить.
+ */
+typedef struct {
+    SearchFrame *frames;           // Кадры глубин 0..N
+    uint32_t depth;                // Глубина текущего узла
+    uint32_t base_depth;           // Глубина корня (префикс поддерева)
+    bool entering;                 // Текущий узел еще не обработан на входе
+    bool active;                   // Поиск не завершен
+    bool complete;                 // Дерево перебрано полностью (не first_only)
+} SearchStack;
+
 /**
  * Контекст backtrack решателя
  */
@@ -46,12 +96,42 @@ typedef struct {
     value_t best_max;
     NumberSet best_solution;
     bool has_solution;
+    NumberSet incumbent;           // Начальное решение (size = 0 - нет)
+    value_t decision_max;          // Распознавание: максимум ровно M (0 - оптимизация)
+    bool stop_on_first;            // Остановка после первого решения
 
     // Все оптимальные решения (если find_all_optimal = true)
     NumberSet *all_optimal_solutions;
     size_t optimal_count;
     size_t optimal_capacity;
 
+    // Потоковая выдача оптимальных (NULL - копятся в all_optimal_solutions)
+    OptimalSetCallback optimal_callback;
+    void *optimal_user_data;
+    size_t optimal_streamed;       // Выдано при текущем лучшем максимуме
+    NumberSet stream_set;          // Буфер выдаваемого множества
+
+    // Общий лучший максимум параллельного поиска (NULL - поиск один)
+    _Atomic value_t *shared_best_max;
+
+    // Доказанная нижняя граница максимума (NULL - нет), читается в поиске
+    const _Atomic value_t *shared_lower_bound;
+
+    // Кеш тупиков (NULL - выключен), свой или общий для воркеров
+    NogoodCache *nogood_cache;
+    bool owns_nogood_cache;
+    uint64_t nogood_hits;          // Узлов отсечено кешем
+    uint64_t nogood_stores;        // Записанных тупиков
+
+    // Состояние перебора
+    SearchStack stack;
+    SearchBounds bounds;           // Отсечения по префиксу
+    double run_time;               // Время в backtrack_solver_run, сек
+    double budget_start;           // Начало запуска для time_limit_sec
+    uint64_t budget_nodes_start;   // Узлы на начало запуска для node_limit
+    bool budget_exhausted;         // Ограничение запуска исчерпано
+    uint64_t hot_allocations_start;  // Счетчик аллокаций менеджера при старте
+
     // Статистика
     SearchStats stats;
 
@@ -89,8 +169,86 @@ void backtrack_solver_set_progress_callback(BacktrackSolver *solver,
                                             ProgressCallback callback,
                                             void *user_data);
 
+/**
+ * Потоковая выдача оптимальных множеств вместо списка в памяти
+ * Память решателя не растет с числом решений, список
+ * backtrack_solver_get_optimal_solutions остается пустым.
+ */
+void backtrack_solver_set_optimal_callback(BacktrackSolver *solver,
+                                           OptimalSetCallback callback,
+                                           void *user_data);
+
+/**
+ * Установка начального решения (инкумбента), например конструкции
+ * Конвея - Гая. Применяется при каждой подготовке поиска: решение сразу
+ * считается лучшим, граница кандидатов берется по его максимуму.
+ * В режиме first_only поиск с инкумбентом сразу возвращает его.
+ */
+void backtrack_solver_set_incumbent(BacktrackSolver *solver, const NumberSet *set);
+
+/**
+ * Начало поиска: сброс состояния и установка корня
+ * Сам перебор выполняет backtrack_solver_run, результат - backtrack_solver_finish.
+ */
+void backtrack_solver_begin(BacktrackSolver *solver);
+
+/**
+ * Начало распознавания вместо backtrack_solver_begin: существует ли
+ * множество с наибольшим элементом ровно max_value? Последняя позиция
+ * фиксируется значением max_value, граница кандидатов и отсечения
+ * берутся по нему, инкумбент не используется. Без find_all_optimal
+ * поиск останавливается на первом решении.
+ * После backtrack_solver_run: решение есть - has_solution, поиск
+ * завершен без решения - такого множества нет.
+ */
+void backtrack_solver_begin_decision(BacktrackSolver *solver, value_t max_value);
+
+/**
+ * Продолжение поиска не более чем на node_budget узлов
+ * Возвращает true, если поиск завершен; false - приостановлен (исчерпан
+ * бюджет или выставлен флаг остановки), его можно продолжить тем же вызовом.
+ */
+bool backtrack_solver_run(BacktrackSolver *solver, uint64_t node_budget);
+
+/**
+ * Завершен ли поиск
+ */
+bool backtrack_solver_is_finished(const BacktrackSolver *solver);
+
+/**
+ * Исчерпано ли ограничение запуска (config.time_limit_sec, node_limit)
+ * Ограничения отсчитываются от backtrack_solver_prepare, для точки -
+ * от восстановления: каждый запуск получает полный бюджет.
+ */
+bool backtrack_solver_budget_exhausted(const BacktrackSolver *solver);
+
+/**
+ * Заполнение результата по текущему состоянию
+ * Незавершенный поиск дает INTERRUPTED (по флагу остановки) или TIMEOUT,
+ * остановленный first_only - FEASIBLE; лучшее найденное решение при этом
+ * тоже возвращается.
+ */
+void backtrack_solver_finish(BacktrackSolver *solver, SolutionResult *result);
+
+/**
+ * Сохранение состояния поиска в контрольную точку
+ * Вызывается между backtrack_solver_run; checkpoint должен быть
+ * инициализирован search_checkpoint_init.
+ */
+void backtrack_solver_save_checkpoint(const BacktrackSolver *solver,
+                                      SearchCheckpoint *checkpoint);
+
+/**
+ * Продолжение поиска с контрольной точки вместо backtrack_solver_begin
+ * Возвращает false, если точка не подходит к решателю (другое N,
+ * поврежденный префикс) - тогда поиск нужно начать заново.
+ */
+bool backtrack_solver_restore_checkpoint(BacktrackSolver *solver,
+                                         const SearchCheckpoint *checkpoint);
+
 /**
  * Решение задачи - поиск первого оптимального решения
+ * begin + run без ограничения + finish
  * Возвращает результат в структуру result
  */
 void backtrack_solver_solve(BacktrackSolver *solver, SolutionResult *result);
@@ -102,6 +260,54 @@ void backtrack_solver_solve(BacktrackSolver *solver, SolutionResult *result);
  */
 void backtrack_solver_solve_all(BacktrackSolver *solver, SolutionResult *result);
 
+/**
+ * Подготовка к поиску по частям (параллельный поиск):
+ * сброс статистики, решения и менеджера, установка начальной границы
+ */
+void backtrack_solver_prepare(BacktrackSolver *solver);
+
+/**
+ * Подключение общего лучшего максимума (0 = решения нет)
+ * Граница кандидатов берется как минимум из своего и общего максимума,
+ * найденные решения публикуются атомарным минимумом.
+ */
+void backtrack_solver_set_shared_bound(BacktrackSolver *solver,
+                                       _Atomic value_t *shared_best_max);
+
+/**
+ * Подключение нижней границы максимума, которую могут поднять другие потоки
+ * Лучший максимум на границе оптимален: перебор завершается как полный
+ * (кроме поиска всех оптимальных). Граница проверяется после решений и
+ * вместе с прогрессом.
+ */
+void backtrack_solver_set_lower_bound(BacktrackSolver *solver,
+                                      const _Atomic value_t *lower_bound);
+
+/**
+ * Подключение общего кеша тупиков вместо своего (NULL - выключить)
+ * Кеш принадлежит вызывающему и должен жить дольше решателя.
+ */
+void backtrack_solver_set_nogood_cache(BacktrackSolver *solver, NogoodCache *cache);
+
+/**
+ * Загрузка префикса поддерева в менеджер (сброс и повторное добавление)
+ * Возвращает false, если префикс не является B-последовательностью
+ */
+bool backtrack_solver_load_prefix(BacktrackSolver *solver, const value_t *prefix,
+                                  uint32_t depth);
+
+/**
+ * Следующий потомок текущего префикса: наименьший допустимый кандидат
+ * не меньше from под текущей границей. Найденный кандидат добавляется в
+ * менеджер и возвращается в *child; false - потомков больше нет.
+ */
+bool backtrack_solver_next_child(BacktrackSolver *solver, value_t from, value_t *child);
+
+/**
+ * Полный перебор поддерева префикса, загруженного в менеджер
+ */
+void backtrack_solver_search_subtree(BacktrackSolver *solver);
+
 /**
  * Получение всех оптимальных решений
  * Возвращает количество решений, solutions - массив NumberSet
@@ -109,6 +315,13 @@ void backtrack_solver_solve_all(BacktrackSolver *solver, SolutionResult *result)
 size_t backtrack_solver_get_optimal_solutions(const BacktrackSolver *solver,
                                               NumberSet **solutions);
 
+/**
+ * Число оптимальных решений с текущим максимумом: в списке и выданных потоком
+ */
+static inline size_t backtrack_solver_optimal_total(const BacktrackSolver *solver) {
+    return solver->optimal_count + solver->optimal_streamed;
+}
+
 /**
  * Получение статистики поиска
  */
@@ -124,10 +337,22 @@ void backtrack_solver_get_stats(const BacktrackSolver *solver, SearchStats *stat
  */
 value_t compute_initial_bound(uint32_t n);
 
+/**
+ * Результат проверки множества
+ */
+typedef enum {
+    B_SEQUENCE_VALID,              // Все суммы подмножеств различны
+    B_SEQUENCE_INVALID,            // Есть равные суммы
+    B_SEQUENCE_UNKNOWN             // Проверка не выполнена (ошибка, см. лог)
+} BSequenceCheck;
+
 /**
  * Проверка, является ли множество B-последовательностью
  * (все суммы подмножеств различны)
+ * До 20 элементов - отсортированными суммами в памяти, больше - внешним
+ * слиянием (external_sums.h); B_SEQUENCE_UNKNOWN - проверка не выполнена
+ * (ввод-вывод, память, n > 62), о самом множестве это ничего не говорит.
  */
-bool is_valid_b_sequence(const NumberSet *set);
+BSequenceCheck check_b_sequence(const NumberSet *set);
 
 #endif // ERDOS_BACKTRACK_SOLVER_H
@@ -0,0 +1,86 @@
+/**
+ * bound_board.h - Общие границы для одновременно решаемых N
+ *
+ * run_range решает несколько N одновременно, а границы разных N связаны:
+ * - любой префикс множества с различными суммами - тоже такое множество,
+ *   поэтому решение для N дает решения для всех k < N (максимум - k-й
+ *   элемент по возрастанию), то есть верхние границы для них;
+ * - f(N) строго возрастает, поэтому доказанный оптимум f(N) дает нижние
+ *   границы f(M) >= f(N) + (M - N) для M > N.
+ *
+ * Доска хранит для каждого N лучший известный максимум (атомарно - его
+ * читают решатели как общую границу кандидатов), множество с этим
+ * максимумом и доказанную нижнюю границу. Решатель, у которого лучший
+ * максимум достиг нижней границы, завершает перебор: решение оптимально.
+ */
+
+#ifndef ERDOS_BOUND_BOARD_H
+#define ERDOS_BOUND_BOARD_H
+
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "types.h"
+
+// ============================================================================
+// Константы
+// ============================================================================
+
+// Наибольшее N на доске (дальше value_t не вмещает максимумы)
+#define BOUND_BOARD_MAX_N 64
+
+// ============================================================================
+// Структуры
+// ============================================================================
+
+/**
+ * Границы одного N
+ */
+typedef struct {
+    _Atomic value_t upper;         // Лучший известный максимум (0 = нет)
+    _Atomic value_t lower;         // Доказанная нижняя граница f(N) (0 = нет)
+    NumberSet set;                 // Лучшее известное множество, под lock
+} BoundSlot;
+
+typedef struct {
+    BoundSlot slots[BOUND_BOARD_MAX_N + 1];
+    pthread_mutex_t lock;
+} BoundBoard;
+
+// ============================================================================
+// Функции
+// ============================================================================
+
+BoundBoard* bound_board_create(void);
+void bound_board_destroy(BoundBoard *board);
+
+/**
+ * Общая граница N для backtrack_solver_set_shared_bound (NULL - N вне доски)
+ * Решатель может понизить ее своим максимумом без множества; множество
+ * приходит через bound_board_publish.
+ */
+_Atomic value_t* bound_board_upper(BoundBoard *board, uint32_t n);
+
+/**
+ * Нижняя граница N для backtrack_solver_set_lower_bound (NULL - N вне доски)
+ */
+const _Atomic value_t* bound_board_lower(BoundBoard *board, uint32_t n);
+
+/**
+ * Публикация множества (по возрастанию): оно и его префиксы понижают
+ * верхние границы своих размеров
+ */
+void bound_board_publish(BoundBoard *board, const NumberSet *set);
+
+/**
+ * Доказанный оптимум f(n) = max_value: нижние границы n и всех M > n
+ */
+void bound_board_set_optimal(BoundBoard *board, uint32_t n, value_t max_value);
+
+/**
+ * Копия лучшего известного множества N
+ * Возвращает false, если множества нет.
+ */
+bool bound_board_get(BoundBoard *board, uint32_t n, NumberSet *set);
+
+#endif // ERDOS_BOUND_BOARD_H
@@ -0,0 +1,62 @@
+/**
+ * constructions.h - Явные конструкции множеств с различными суммами
+ *
+ * Конструкция дает решение до начала перебора: его максимум сразу
+ * становится границей кандидатов, а само множество - текущим лучшим
+ * решением (инкумбентом) вместо границы 2^(n-1) + 1.
+ */
+
+#ifndef ERDOS_CONSTRUCTIONS_H
+#define ERDOS_CONSTRUCTIONS_H
+
+#include <stdbool.h>
+#include "types.h"
+
+// ============================================================================
+// Константы
+// ============================================================================
+
+// Различность сумм последовательности Конвея - Гая проверена для n < 80
+// (Lunnon); без собственной проверки используется до этого n
+#define CONWAY_GUY_VERIFIED_MAX_N 79
+
+// Сдвигов d на одно (n-1)-множество при продолжении до n и наибольшее n
+// для сдвигов: проверка сдвига строит D-маску ширины O(сумма элементов),
+// при n = 20 перебор сдвигов - секунды, а точный перебор не завершается
+#define EXTEND_MAX_SHIFTS (1u << 12)
+#define EXTEND_SHIFT_MAX_N 18
+
+// ============================================================================
+// Функции
+// ============================================================================
+
+/**
+ * Множество Конвея - Гая размера n: u_0 = 0, u_1 = 1,
+ * u_{m+1} = 2u_m - u_{m-r}, r = round(sqrt(2m)); множество {u_n - u_{n-i}}
+ * Результат упорядочен по возрастанию. Возвращает false, если значения
+ * не помещаются в value_t.
+ */
+bool conway_guy_set(uint32_t n, NumberSet *set);
+
+/**
+ * Лучшее известное построенное решение для n, годное как инкумбент
+ * Множество проверяется check_b_sequence, пока проверка в памяти;
+ * дальше используется только в пределах CONWAY_GUY_VERIFIED_MAX_N.
+ * Возвращает false, если конструкции нет.
+ */
+bool construct_incumbent(uint32_t n, NumberSet *set);
+
+/**
+ * Продолжение известных (n-1)-множеств до n-множества с максимумом < bound
+ * Для каждого источника A (по возрастанию) проверяются:
+ * - расширение A ∪ {v} с наименьшим v вне знаковых сумм A (D-маска);
+ * - сдвиг {d} ∪ (A + d) с наименьшим допустимым d (не больше
+ *   EXTEND_MAX_SHIFTS, только n <= EXTEND_SHIFT_MAX_N) - так из множества
+ *   Конвея - Гая {u_n - u_i} получается следующее, d = u_{n+1} - u_n.
+ * bound = 0 - без ограничения. Результат упорядочен по возрастанию.
+ * Возвращает false, если ничего лучше bound не найдено или n > 24.
+ */
+bool extend_smaller_sets(uint32_t n, const NumberSet *sources, size_t count,
+                         value_t bound, NumberSet *set);
+
+#endif // ERDOS_CONSTRUCTIONS_H
@@ -43,6 +43,10 @@ void db_manager_destroy(DatabaseManager *manager);
 
 /**
  * Сохранение результата решения
+ * Незавершенный результат (TIMEOUT, FEASIBLE, INTERRUPTED) хранится в
+ * одной строке на N: она заменяется при равной или лучшей границе и не
+ * пишется, если N уже решено. OPTIMAL удаляет незавершенную строку N и
+ * множества optimal_sets с большим максимумом.
  */
 bool db_manager_save_result(DatabaseManager *manager, const SolutionResult *result);
 
@@ -52,6 +56,73 @@ bool db_manager_save_result(DatabaseManager *manager, const SolutionResult *resu
 bool db_manager_save_optimal_sets(DatabaseManager *manager, uint32_t n,
                                   const NumberSet *sets, size_t count);
 
+/**
+ * Удаление оптимальных множеств N с максимумом больше max_value
+ * (найден строго лучший максимум)
+ */
+bool db_manager_delete_optimal_sets_above(DatabaseManager *manager, uint32_t n,
+                                         value_t max_value);
+
+/**
+ * Предварительные множества N (optimal_sets_pending): поток поиска всех
+ * оптимальных пишет их до завершения перебора. Оптимальными они станут,
+ * только если перебор завершится с OPTIMAL (db_manager_promote_pending_sets).
+ */
+bool db_manager_save_pending_sets(DatabaseManager *manager, uint32_t n,
+                                  const NumberSet *sets, size_t count);
+
+/**
+ * Удаление предварительных множеств N с максимумом больше max_value
+ */
+bool db_manager_delete_pending_sets_above(DatabaseManager *manager, uint32_t n,
+                                         value_t max_value);
+
+/**
+ * Наименьший максимум предварительных множеств N
+ * Возвращает false, если множеств нет
+ */
+bool db_manager_get_pending_sets_max(DatabaseManager *manager, uint32_t n, value_t *max_value);
+
+/**
+ * Перенос предварительных множеств N с максимумом max_value в optimal_sets
+ * (перебор доказал оптимум), остальные предварительные удаляются
+ */
+bool db_manager_promote_pending_sets(DatabaseManager *manager, uint32_t n,
+                                     value_t max_value);
+
+/**
+ * Удаление всех предварительных множеств N (перебор не завершен)
+ */
+bool db_manager_discard_pending_sets(DatabaseManager *manager, uint32_t n);
+
+// ============================================================================
+// Контрольные точки
+// ============================================================================
+
+/**
+ * Сохранение контрольной точки поиска для N (заменяет предыдущую)
+ */
+bool db_manager_save_checkpoint(DatabaseManager *manager,
+                                const SearchCheckpoint *checkpoint);
+
+/**
+ * Загрузка контрольной точки для N
+ * checkpoint должен быть инициализирован search_checkpoint_init
+ * Возвращает true если точка найдена и корректна
+ */
+bool db_manager_load_checkpoint(DatabaseManager *manager, uint32_t n,
+                                SearchCheckpoint *checkpoint);
+
+/**
+ * Удаление контрольной точки для N (после завершения поиска)
+ */
+bool db_manager_delete_checkpoint(DatabaseManager *manager, uint32_t n);
+
+/**
+ * Есть ли контрольная точка для N
+ */
+bool db_manager_has_checkpoint(DatabaseManager *manager, uint32_t n);
+
 // ============================================================================
 // Функции загрузки
 // ============================================================================
@@ -63,6 +134,14 @@ bool db_manager_save_optimal_sets(DatabaseManager *manager, uint32_t n,
 bool db_manager_get_result(DatabaseManager *manager, uint32_t n,
                            SolutionResult *result);
 
+/**
+ * Результат N с наименьшим максимумом любого статуса (в том числе
+ * TIMEOUT и FEASIBLE незавершенных запусков) с непустым множеством
+ * Возвращает true если результат найден
+ */
+bool db_manager_get_best_known(DatabaseManager *manager, uint32_t n,
+                               SolutionResult *result);
+
 /**
  * Получение лучшей известной границы для N
  * Возвращает true если граница найдена
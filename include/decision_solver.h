@@ -0,0 +1,119 @@
+/**
+ * decision_solver.h - Поиск через задачи распознавания по максимуму
+ *
+ * Вместо ветвей и границ с убывающим лучшим максимумом решается серия
+ * задач "существует ли множество с наибольшим элементом ровно M?" для
+ * M = L, L + 1, ... от доказанной нижней границы L. Наибольший элемент
+ * зафиксирован, поэтому граница кандидатов и отсечения (search_bounds.h)
+ * с самого начала максимально сильные.
+ *
+ * Воркеры берут значения M по возрастанию, у каждого свой решатель.
+ * Первое M с решением оптимально: все меньшие M доказаны пустыми. Как
+ * только решение найдено для M, проверки больших M отменяются, а меньшие
+ * дорабатывают до конца. Если пусты все M ниже максимума инкумбента,
+ * оптимален инкумбент.
+ */
+
+#ifndef ERDOS_DECISION_SOLVER_H
+#define ERDOS_DECISION_SOLVER_H
+
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "types.h"
+#include "backtrack_solver.h"
+
+// ============================================================================
+// Структуры
+// ============================================================================
+
+struct DecisionSolver;
+
+/**
+ * Воркер: проверяет по одному M своим решателем
+ */
+typedef struct {
+    pthread_t thread;
+    struct DecisionSolver *owner;
+    BacktrackSolver *solver;       // Свой решатель и менеджер сумм
+    value_t max_value;             // Проверяемое M (0 = нет), под lock
+    volatile bool cancel;          // Флаг остановки решателя воркера
+    _Atomic uint64_t nodes;        // Узлы текущей проверки для прогресса
+    _Atomic uint64_t done_nodes;   // Узлы завершенных проверок
+} DecisionWorker;
+
+/**
+ * Контекст поиска через распознавание
+ */
+typedef struct DecisionSolver {
+    SolverConfig config;
+    uint32_t thread_count;
+    DecisionWorker *workers;
+
+    NumberSet incumbent;           // Известное решение (size = 0 - нет)
+    value_t lower_bound;           // Внешняя нижняя граница максимума (0 - нет)
+
+    pthread_mutex_t lock;          // Раздача M и сбор результатов
+    value_t next_max;              // Следующее M для раздачи
+    value_t last_max;              // Последнее M, которое нужно проверить
+    value_t feasible_max;          // Наименьшее M с решением (0 = нет)
+    NumberSet best_solution;       // Решение для feasible_max
+    _Atomic uint32_t running;      // Работающие воркеры
+    SearchBounds bounds;           // Сводка отсечений всех проверок
+
+    // Все оптимальные решения (если find_all_optimal = true)
+    NumberSet *all_optimal_solutions;
+    size_t optimal_count;
+    size_t optimal_streamed;       // Выданных потоком для feasible_max
+} DecisionSolver;
+
+// ============================================================================
+// Функции
+// ============================================================================
+
+/**
+ * Создание решателя
+ * thread_count - число одновременно проверяемых M (0 = по числу ядер)
+ */
+DecisionSolver* decision_solver_create(const SolverConfig *config, uint32_t thread_count);
+
+/**
+ * Освобождение решателя
+ */
+void decision_solver_destroy(DecisionSolver *solver);
+
+/**
+ * Известное решение: проверяются только M ниже его максимума
+ * (в режиме всех оптимальных - включая максимум)
+ */
+void decision_solver_set_incumbent(DecisionSolver *solver, const NumberSet *set);
+
+/**
+ * Внешняя нижняя граница максимума, например f(n-1) + 1
+ * Итоговая граница - наибольшая из внешней и границы правил отсечения.
+ */
+void decision_solver_set_lower_bound(DecisionSolver *solver, value_t lower_bound);
+
+/**
+ * Потоковая выдача оптимальных множеств (см. backtrack_solver_set_optimal_callback)
+ * callback вызывается из потоков воркеров одновременно, в том числе для
+ * M, которое позже окажется не наименьшим.
+ */
+void decision_solver_set_optimal_callback(DecisionSolver *solver,
+                                          OptimalSetCallback callback,
+                                          void *user_data);
+
+/**
+ * Решение задачи (при config.find_all_optimal - всех оптимальных)
+ * Возвращает результат в структуру result
+ */
+void decision_solver_solve(DecisionSolver *solver, SolutionResult *result);
+
+/**
+ * Получение всех оптимальных решений
+ * Возвращает количество решений, solutions - массив NumberSet
+ */
+size_t decision_solver_get_optimal_solutions(const DecisionSolver *solver,
+                                             NumberSet **solutions);
+
+#endif // ERDOS_DECISION_SOLVER_H
@@ -0,0 +1,57 @@
+/**
+ * external_sums.h - Внешняя (out-of-core) проверка сумм подмножеств
+ *
+ * Для больших N все 2^N сумм не помещаются в память. Элементы делятся на
+ * младшую часть (2^r сумм) и старшую (2^(N-r) сумм). Отсортированные суммы
+ * младшей части записываются во временный файл, отображенный в память (mmap),
+ * а каждый прогон - это та же таблица, сдвинутая на сумму старшей части.
+ * Различность всех сумм проверяется k-путевым слиянием этих прогонов.
+ */
+
+#ifndef ERDOS_EXTERNAL_SUMS_H
+#define ERDOS_EXTERNAL_SUMS_H
+
+#include <stdbool.h>
+#include "types.h"
+
+// ============================================================================
+// Константы
+// ============================================================================
+
+#define EXTERNAL_DEFAULT_RUN_LOG2 24
+
+// ============================================================================
+// Настройки
+// ============================================================================
+
+/**
+ * Параметры внешней проверки
+ */
+typedef struct {
+    const char *temp_dir;      // Каталог временных файлов (NULL = $TMPDIR или /tmp)
+    uint32_t run_log2;         // log2 длины прогона (0 = EXTERNAL_DEFAULT_RUN_LOG2)
+} ExternalSumsOptions;
+
+/**
+ * Результат внешней проверки
+ */
+typedef enum {
+    EXTERNAL_SUMS_DISTINCT,    // Все суммы различны
+    EXTERNAL_SUMS_COLLISION,   // Есть равные суммы
+    EXTERNAL_SUMS_ERROR        // Проверка не выполнена (ввод-вывод, память, n > 62,
+                               // сумма элементов не помещается в value_t)
+} ExternalSumsResult;
+
+// ============================================================================
+// Функции проверки
+// ============================================================================
+
+/**
+ * Проверка, что все 2^count сумм подмножеств elements различны
+ * options может быть NULL (параметры по умолчанию).
+ * EXTERNAL_SUMS_ERROR пишется в лог и ничего не говорит о множестве.
+ */
+ExternalSumsResult external_sums_check(const value_t *elements, size_t count,
+                                       const ExternalSumsOptions *options);
+
+#endif // ERDOS_EXTERNAL_SUMS_H
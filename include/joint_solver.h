@@ -0,0 +1,98 @@
+/**
+ * joint_solver.h - Совместный поиск для диапазона N одним обходом дерева
+ *
+ * Любой префикс множества с различными суммами - тоже такое множество,
+ * поэтому дерево перебора N (построение снизу) содержит деревья всех
+ * k < N: узел глубины k - кандидат в решение для k. Совместный поиск
+ * обходит одно дерево до глубины max_n и хранит лучший максимум best[k]
+ * для каждого целевого k из [min_n, max_n].
+ *
+ * Узел отсекается, только если не может улучшить ни одну цель: у узла
+ * маска живых целей k > depth (следующий кандидат v дает максимум не
+ * меньше v + (k - depth - 1), плюс правила search_bounds для размера k
+ * под best[k]). Цель, умершая в узле, мертва и во всем его поддереве:
+ * границы только убывают. Кандидаты узла ограничены наибольшей из границ
+ * живых целей.
+ *
+ * Поиск последовательный, без контрольных точек и поиска всех
+ * оптимальных; ограничения запуска (time_limit_sec, node_limit) - общие
+ * на весь обход.
+ */
+
+#ifndef ERDOS_JOINT_SOLVER_H
+#define ERDOS_JOINT_SOLVER_H
+
+#include <stdbool.h>
+#include "types.h"
+#include "subset_sum_manager.h"
+#include "search_bounds.h"
+
+// ============================================================================
+// Константы
+// ============================================================================
+
+// Наибольшее N совместного поиска (цели - биты маски)
+#define JOINT_MAX_N 63
+
+// ============================================================================
+// Структуры
+// ============================================================================
+
+/**
+ * Кадр явного стека
+ */
+typedef struct {
+    value_t next_candidate;        // Наименьший еще не рассмотренный кандидат
+    uint64_t alive;                // Цели (бит k), которые узел еще может улучшить
+} JointFrame;
+
+typedef struct {
+    SolverConfig config;           // config.n - наибольшее N диапазона
+    uint32_t min_n;
+    uint64_t targets;              // Цели поиска (бит k)
+
+    SubsetSumManager *manager;
+    SearchBounds bounds;
+    JointFrame *frames;            // Кадры глубин 0..n
+
+    value_t *best_max;             // best_max[k] - лучший максимум k (0 = нет)
+    NumberSet *best_solutions;     // best_solutions[k] (size == k - решение есть)
+
+    uint64_t nodes_explored;
+    uint64_t cuts;                 // Узлов без живых целей
+} JointSolver;
+
+// ============================================================================
+// Функции
+// ============================================================================
+
+/**
+ * Создание поиска для N из [min_n, config->n]
+ */
+JointSolver* joint_solver_create(const SolverConfig *config, uint32_t min_n);
+
+/**
+ * Освобождение
+ */
+void joint_solver_destroy(JointSolver *solver);
+
+/**
+ * Начальное решение (по возрастанию): оно и его префиксы дают границы
+ * best_max своих размеров
+ */
+void joint_solver_set_incumbent(JointSolver *solver, const NumberSet *set);
+
+/**
+ * Исключение N из целей (например, уже решено)
+ */
+void joint_solver_skip(JointSolver *solver, uint32_t n);
+
+/**
+ * Обход дерева
+ * results - массив на config->n - min_n + 1 результатов (индекс N - min_n);
+ * исключенные N не заполняются. Без начального решения N граница -
+ * степени двойки. Полный обход - OPTIMAL для всех целей.
+ */
+void joint_solver_solve(JointSolver *solver, SolutionResult *results);
+
+#endif // ERDOS_JOINT_SOLVER_H
@@ -0,0 +1,140 @@
+/**
+ * local_search.h - Локальный поиск (имитация отжига) верхних границ
+ *
+ * Точный перебор не доказывает оптимальность при больших N, но ему
+ * нужна как можно меньшая начальная граница. Локальный поиск ищет
+ * множества с различными суммами подмножеств под целевым максимумом T:
+ * состояние - N различных значений из [1, T], ход заменяет один элемент
+ * x на y, ухудшение принимается с вероятностью exp(-delta / t).
+ *
+ * Цель хода - число коллизий сумм в окнах: окно - не больше
+ * LOCAL_SEARCH_WINDOW элементов, среди них измененный, его 2^m сумм
+ * подмножеств строятся слиянием по возрастанию, коллизии - равные
+ * соседи. delta - изменение коллизий в LOCAL_SEARCH_MOVE_WINDOWS
+ * случайных окнах, ход стоит O(2^LOCAL_SEARCH_WINDOW) при любом N,
+ * память - 2^LOCAL_SEARCH_WINDOW значений на поток. Это оценка только для
+ * эвристики: при N <= LOCAL_SEARCH_WINDOW окно - все множество и оценка
+ * точна, при больших N видны лишь соотношения внутри окон.
+ *
+ * Множество без коллизий в окнах хода проходит отсев (еще
+ * LOCAL_SEARCH_SCREEN_WINDOWS случайных окон) и точную проверку
+ * check_b_sequence (при N > 24 - внешнюю, по одной за раз); после
+ * непрошедшей проверки следующая - не раньше чем через N * 2^k ходов
+ * (k - непрошедших подряд). Только проверенное множество публикуется
+ * как общий лучший максимум m, цель становится T = m - 1, элементы
+ * больше T заменяются. Потоки ищут независимо со своим состоянием и
+ * общим лучшим максимумом. Найденные множества оптимальность не
+ * доказывают (статус FEASIBLE).
+ */
+
+#ifndef ERDOS_LOCAL_SEARCH_H
+#define ERDOS_LOCAL_SEARCH_H
+
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "types.h"
+#include "backtrack_solver.h"
+
+// ============================================================================
+// Константы
+// ============================================================================
+
+// Время поиска без --time-limit и --node-limit, сек
+#define LOCAL_SEARCH_DEFAULT_TIME_SEC 60
+
+// Наибольшее число элементов окна (2^LOCAL_SEARCH_WINDOW сумм)
+#define LOCAL_SEARCH_WINDOW 16
+
+// Окон на оценку хода
+#define LOCAL_SEARCH_MOVE_WINDOWS 4
+
+// Окон отсева перед точной проверкой
+#define LOCAL_SEARCH_SCREEN_WINDOWS 32
+
+// ============================================================================
+// Структуры
+// ============================================================================
+
+struct LocalSearch;
+
+/**
+ * Поток локального поиска со своим состоянием
+ */
+typedef struct {
+    pthread_t thread;
+    struct LocalSearch *owner;
+    uint64_t rng;                  // Состояние xorshift64*
+    value_t *elements;             // Текущее множество (N различных значений)
+    uint32_t *order;               // Перестановка индексов для выбора окон
+    value_t target;                // Наибольшее допустимое значение элемента
+
+    // Отсортированные суммы окна и буфер слияния
+    value_t *sums;
+    value_t *scratch;
+
+    uint64_t cooldown;             // Ходов до следующей точной проверки
+    uint32_t failures;             // Непрошедших проверок подряд (удлиняют cooldown)
+    _Atomic uint64_t moves;        // Выполненные ходы
+    _Atomic uint64_t checks;       // Точные проверки
+    _Atomic uint64_t rejected;     // Из них не прошли
+} LocalSearchWorker;
+
+/**
+ * Контекст локального поиска
+ */
+typedef struct LocalSearch {
+    SolverConfig config;
+    uint32_t thread_count;
+    LocalSearchWorker *workers;
+
+    NumberSet incumbent;           // Начальное решение (size = 0 - степени двойки)
+    _Atomic value_t best_max;      // Общий лучший максимум
+    pthread_mutex_t lock;          // Публикация улучшений
+    pthread_mutex_t check_lock;    // Точные проверки (внешняя - по одной)
+    NumberSet best_solution;       // Множество для best_max, под lock
+    uint32_t improvements;         // Улучшений за запуск
+    volatile bool stop;            // Остановка потоков
+
+    SolutionCallback improvement_callback;
+    void *callback_user_data;
+} LocalSearch;
+
+// ============================================================================
+// Функции
+// ============================================================================
+
+/**
+ * Создание локального поиска
+ * thread_count - число потоков (0 = по числу ядер)
+ */
+LocalSearch* local_search_create(const SolverConfig *config, uint32_t thread_count);
+
+/**
+ * Освобождение
+ */
+void local_search_destroy(LocalSearch *search);
+
+/**
+ * Начальное решение: поиск начинается с целевого максимума ниже его
+ */
+void local_search_set_incumbent(LocalSearch *search, const NumberSet *set);
+
+/**
+ * Callback для каждого улучшения общего максимума (множество проверено
+ * check_b_sequence). Вызывается из потоков поиска под общей блокировкой.
+ */
+void local_search_set_improvement_callback(LocalSearch *search,
+                                           SolutionCallback callback,
+                                           void *user_data);
+
+/**
+ * Поиск до остановки или ограничения запуска (config.time_limit_sec,
+ * config.node_limit - ходов; без них LOCAL_SEARCH_DEFAULT_TIME_SEC)
+ * Результат - лучшее найденное множество со статусом FEASIBLE; без
+ * улучшений - пустое множество (NO_SOLUTION), начальное решение
+ * результатом поиска не считается.
+ */
+void local_search_solve(LocalSearch *search, SolutionResult *result);
+
+#endif // ERDOS_LOCAL_SEARCH_H
@@ -0,0 +1,90 @@
+/**
+ * nogood_cache.h - Кеш тупиковых состояний поиска
+ *
+ * Поддерево узла при построении снизу определяется глубиной, первым
+ * кандидатом и множеством запрещенных значений T префикса (D-режим
+ * менеджера): разные префиксы с одинаковыми T дают одинаковые поддеревья.
+ * Узел, поддерево которого перебрано без решений, записывается с границей
+ * максимума, под которой это доказано. Граница только убывает, поэтому
+ * запись остается верной и дальше: она отсекает узел, пока текущая
+ * граница не больше записанной.
+ *
+ * Таблица фиксированного размера без блокировок (общая для воркеров
+ * параллельного поиска): запись - пара (hash ^ bound, bound), чтение
+ * проверяет, что слова записаны одной парой. Новая запись вытесняет старую
+ * в той же ячейке.
+ */
+
+#ifndef ERDOS_NOGOOD_CACHE_H
+#define ERDOS_NOGOOD_CACHE_H
+
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "types.h"
+
+// ============================================================================
+// Константы
+// ============================================================================
+
+// Узлы ближе к листьям не кешируются: хеш дороже их поддерева
+#define NOGOOD_MIN_REMAINING 3
+
+// ============================================================================
+// Структуры
+// ============================================================================
+
+typedef struct {
+    _Atomic uint64_t check;        // hash ^ bound
+    _Atomic uint64_t bound;        // Исключительная граница максимума
+} NogoodEntry;
+
+typedef struct {
+    NogoodEntry *entries;
+    size_t mask;                   // Количество записей - 1 (степень двойки)
+} NogoodCache;
+
+// ============================================================================
+// Функции
+// ============================================================================
+
+/**
+ * Создание кеша размером не больше size_mb мегабайт (NULL при 0)
+ */
+NogoodCache* nogood_cache_create(size_t size_mb);
+
+/**
+ * Освобождение кеша
+ */
+void nogood_cache_destroy(NogoodCache *cache);
+
+/**
+ * Ключ состояния: хеш T, глубина и первый кандидат
+ */
+static inline uint64_t nogood_cache_key(uint64_t state_hash, uint32_t depth, value_t next) {
+    uint64_t key = state_hash ^ ((uint64_t)depth << 56) ^ (next * 0x9E3779B97F4A7C15ULL);
+    key ^= key >> 31;
+    key *= 0xBF58476D1CE4E5B9ULL;
+    key ^= key >> 29;
+    return key;
+}
+
+/**
+ * true - поддерево состояния key доказано пустым при границе не меньше bound
+ */
+static inline bool nogood_cache_lookup(const NogoodCache *cache, uint64_t key, value_t bound) {
+    const NogoodEntry *entry = &cache->entries[key & cache->mask];
+    uint64_t stored = atomic_load_explicit(&entry->bound, memory_order_relaxed);
+    uint64_t check = atomic_load_explicit(&entry->check, memory_order_relaxed);
+    return (check ^ stored) == key && bound <= stored;
+}
+
+/**
+ * Запись: поддерево состояния key пусто при исключительной границе bound
+ */
+static inline void nogood_cache_store(NogoodCache *cache, uint64_t key, value_t bound) {
+    NogoodEntry *entry = &cache->entries[key & cache->mask];
+    atomic_store_explicit(&entry->check, key ^ bound, memory_order_relaxed);
+    atomic_store_explicit(&entry->bound, bound, memory_order_relaxed);
+}
+
+#endif // ERDOS_NOGOOD_CACHE_H
@@ -0,0 +1,91 @@
+/**
+ * optimal_writer.h - Фоновая запись оптимальных множеств в БД
+ *
+ * В режиме всех оптимальных решений число множеств заранее неизвестно,
+ * поэтому решатели не копят их в памяти, а выдают потоком
+ * (backtrack_solver_set_optimal_callback). Множества проходят через
+ * очередь фиксированной емкости к фоновому потоку, который пишет их в
+ * таблицу optimal_sets_pending пакетами в одной транзакции. Полная очередь
+ * задерживает решатель до записи, память не растет.
+ *
+ * Строго меньший максимум делает записанные множества неоптимальными:
+ * поток удаляет из БД строки N с большим максимумом и продолжает с
+ * новым. Множества с большим, чем записанный, максимумом пропускаются,
+ * так что в БД всегда лежат только множества с наименьшим найденным
+ * максимумом. Это еще не оптимум: после перебора вызывающий переносит
+ * их в optimal_sets (OPTIMAL) или удаляет (db_manager_promote_pending_sets,
+ * db_manager_discard_pending_sets).
+ */
+
+#ifndef ERDOS_OPTIMAL_WRITER_H
+#define ERDOS_OPTIMAL_WRITER_H
+
+#include <stdbool.h>
+#include <pthread.h>
+#include "types.h"
+#include "db_manager.h"
+
+// ============================================================================
+// Константы
+// ============================================================================
+
+// Емкость очереди по умолчанию (множеств)
+#define OPTIMAL_WRITER_QUEUE_CAPACITY 4096
+
+// ============================================================================
+// Структуры
+// ============================================================================
+
+typedef struct {
+    DatabaseManager *db;
+    uint32_t n;
+
+    // Кольцевая очередь множеств, память выделена при создании
+    NumberSet *queue;
+    size_t capacity;
+    size_t head;
+    size_t count;
+    NumberSet *batch;              // Пакет записи, забирается из очереди целиком
+
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    bool closing;
+    bool running;                  // Фоновый поток запущен
+    pthread_t thread;
+
+    // Состояние записи (только фоновый поток, после закрытия - читать)
+    value_t persisted_max;         // Максимум множеств в БД (0 = нет)
+    size_t persisted_count;        // Записано множеств с этим максимумом
+} OptimalWriter;
+
+// ============================================================================
+// Функции
+// ============================================================================
+
+/**
+ * Создание очереди и запуск фонового потока для N
+ * capacity - емкость очереди (0 = OPTIMAL_WRITER_QUEUE_CAPACITY)
+ * Записанный максимум берется из БД: предварительные множества прошлого
+ * прерванного запуска (с контрольной точкой) остаются, пока не найден
+ * меньший максимум.
+ */
+OptimalWriter* optimal_writer_create(DatabaseManager *db, uint32_t n, size_t capacity);
+
+/**
+ * Постановка множества в очередь (копируется; блокирует, если очередь полна)
+ * Безопасно вызывать из нескольких потоков.
+ */
+void optimal_writer_push(OptimalWriter *writer, const NumberSet *set);
+
+/**
+ * Запись оставшихся множеств и остановка фонового потока
+ */
+void optimal_writer_close(OptimalWriter *writer);
+
+/**
+ * Закрытие (если не закрыт) и освобождение
+ */
+void optimal_writer_destroy(OptimalWriter *writer);
+
+#endif // ERDOS_OPTIMAL_WRITER_H
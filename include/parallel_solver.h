@@ -0,0 +1,165 @@
+/**
+ * parallel_solver.h - Параллельный поиск для одного N
+ *
+ * Дерево поиска делится на поддеревья по префиксам длины split_depth.
+ * Задача - префикс и наименьший еще не рассмотренный кандидат на следующую
+ * позицию. Воркер берет первого допустимого потомка, а остаток задачи
+ * (следующие кандидаты) кладет в свою деку: сам он забирает задачи с конца
+ * (обход в глубину, как у последовательного поиска), простаивающие воркеры
+ * крадут с начала - самые неглубокие, то есть самые большие поддеревья.
+ *
+ * У каждого воркера свой решатель и менеджер сумм, состояние менеджера
+ * восстанавливается повторным добавлением префикса. Лучший максимум общий
+ * и обновляется атомарно, поэтому решение, найденное одним потоком, сразу
+ * сужает границу кандидатов во всех остальных.
+ */
+
+#ifndef ERDOS_PARALLEL_SOLVER_H
+#define ERDOS_PARALLEL_SOLVER_H
+
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "types.h"
+#include "backtrack_solver.h"
+
+// ============================================================================
+// Константы
+// ============================================================================
+
+#define PARALLEL_MAX_SPLIT_DEPTH 16
+#define PARALLEL_DEFAULT_SPLIT_DEPTH 3
+
+// ============================================================================
+// Структуры
+// ============================================================================
+
+/**
+ * Задача: потомки префикса, начиная с кандидата next
+ */
+typedef struct {
+    value_t prefix[PARALLEL_MAX_SPLIT_DEPTH];
+    uint32_t depth;                // Длина префикса
+    value_t next;                  // Наименьший кандидат на позицию depth
+} ParallelTask;
+
+/**
+ * Дека задач воркера (кольцевой буфер под мьютексом)
+ * Владелец работает с концом, воры - с началом.
+ */
+typedef struct {
+    ParallelTask *tasks;
+    size_t head;                   // Индекс первой задачи
+    size_t count;                  // Количество задач
+    size_t capacity;
+    pthread_mutex_t lock;
+} TaskDeque;
+
+struct ParallelSolver;
+
+/**
+ * Воркер параллельного поиска
+ */
+typedef struct {
+    pthread_t thread;
+    struct ParallelSolver *owner;
+    uint32_t index;
+    BacktrackSolver *solver;       // Свой решатель и менеджер сумм
+    TaskDeque deque;
+    _Atomic uint64_t nodes;        // Узлы, опубликованные для прогресса
+} ParallelWorker;
+
+/**
+ * Контекст параллельного решателя
+ */
+typedef struct ParallelSolver {
+    SolverConfig config;
+    uint32_t thread_count;
+    uint32_t split_depth;
+    ParallelWorker *workers;
+    NogoodCache *nogood_cache;     // Общий кеш тупиков (NULL - выключен)
+
+    _Atomic value_t best_max;      // Общий лучший максимум (0 = решения нет)
+    _Atomic size_t pending;        // Задачи в деках и в работе
+    _Atomic uint32_t running;      // Работающие воркеры
+    volatile bool stop;            // Остановка воркеров
+
+    // Внешние границы (NULL - нет): координатор переносит внешний максимум
+    // в общий и останавливает поиск на доказанной нижней границе
+    _Atomic value_t *external_upper;
+    const _Atomic value_t *external_lower;
+
+    // Решения воркеров (вызывается из их потоков одновременно)
+    SolutionCallback solution_callback;
+    void *solution_user_data;
+
+    // Все оптимальные решения (если find_all_optimal = true)
+    NumberSet *all_optimal_solutions;
+    size_t optimal_count;
+    size_t optimal_streamed;       // Выданных потоком (parallel_solver_set_optimal_callback)
+} ParallelSolver;
+
+// ============================================================================
+// Функции
+// ============================================================================
+
+/**
+ * Создание параллельного решателя
+ * thread_count - число потоков (0 = по числу ядер)
+ * split_depth  - длина префикса поддерева, которое воркер перебирает сам
+ *                (0 = PARALLEL_DEFAULT_SPLIT_DEPTH)
+ */
+ParallelSolver* parallel_solver_create(const SolverConfig *config,
+                                       uint32_t thread_count,
+                                       uint32_t split_depth);
+
+/**
+ * Освобождение параллельного решателя
+ */
+void parallel_solver_destroy(ParallelSolver *solver);
+
+/**
+ * Установка начального решения для всех воркеров
+ * (см. backtrack_solver_set_incumbent)
+ */
+void parallel_solver_set_incumbent(ParallelSolver *solver, const NumberSet *set);
+
+/**
+ * Потоковая выдача оптимальных множеств всех воркеров
+ * (см. backtrack_solver_set_optimal_callback)
+ * callback вызывается из потоков воркеров одновременно.
+ */
+void parallel_solver_set_optimal_callback(ParallelSolver *solver,
+                                          OptimalSetCallback callback,
+                                          void *user_data);
+
+/**
+ * Подключение внешних границ (см. bound_board.h): верхняя читается и
+ * понижается координатором, при лучшем максимуме на нижней границе поиск
+ * завершается с оптимальным решением (кроме поиска всех оптимальных)
+ */
+void parallel_solver_set_external_bounds(ParallelSolver *solver,
+                                         _Atomic value_t *upper,
+                                         const _Atomic value_t *lower);
+
+/**
+ * Callback для каждого улучшения любого воркера
+ */
+void parallel_solver_set_solution_callback(ParallelSolver *solver,
+                                           SolutionCallback callback,
+                                           void *user_data);
+
+/**
+ * Решение задачи (при config.find_all_optimal - всех оптимальных)
+ * Возвращает результат в структуру result
+ */
+void parallel_solver_solve(ParallelSolver *solver, SolutionResult *result);
+
+/**
+ * Получение всех оптимальных решений
+ * Возвращает количество решений, solutions - массив NumberSet
+ */
+size_t parallel_solver_get_optimal_solutions(const ParallelSolver *solver,
+                                             NumberSet **solutions);
+
+#endif // ERDOS_PARALLEL_SOLVER_H
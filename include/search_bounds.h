@@ -0,0 +1,118 @@
+/**
+ * search_bounds.h - Отсечения по необходимым условиям на префикс
+ *
+ * Перед перебором кандидатов узла решатель проверяет, может ли префикс
+ * a_1 < ... < a_d вообще быть дополнен до множества с различными суммами,
+ * если все элементы не больше max_value. Каждое правило - необходимое
+ * условие; префикс отбрасывается первым нарушенным правилом, и у каждого
+ * правила свой счетчик отсечений.
+ *
+ * Состояние (префиксные суммы) хранится по глубинам, поэтому откат к
+ * родителю бесплатный: значение глубины d перезаписывается при следующем
+ * спуске на d.
+ *
+ * Новое правило: значение в BoundRule и функции (построение снизу и
+ * сверху) в таблице правил search_bounds.c.
+ */
+
+#ifndef ERDOS_SEARCH_BOUNDS_H
+#define ERDOS_SEARCH_BOUNDS_H
+
+#include <stdbool.h>
+#include "types.h"
+
+// ============================================================================
+// Правила
+// ============================================================================
+
+typedef enum {
+    BOUND_RULE_COUNTING = 0,       // Сумма k первых элементов >= 2^k - 1
+    BOUND_RULE_VARIANCE,           // Сумма квадратов k первых >= (4^k - 1) / 3
+    BOUND_RULE_COUNT
+} BoundRule;
+
+// Сумма квадратов элементов до 2^40 не помещается в 64 бита
+__extension__ typedef unsigned __int128 bound_wide_t;
+
+#define BOUND_RULES_ALL ((1U << BOUND_RULE_COUNT) - 1)
+
+// ============================================================================
+// Структуры
+// ============================================================================
+
+/**
+ * Состояние отсечений одного решателя
+ */
+typedef struct {
+    uint32_t n;                    // Размер искомого множества
+    uint32_t enabled;              // Маска включенных правил
+    value_t *prefix_sum;           // prefix_sum[d] - сумма первых d элементов
+    bound_wide_t *prefix_sq;       // prefix_sq[d] - сумма квадратов первых d
+    uint64_t checks;               // Проверенных префиксов
+    uint64_t cuts[BOUND_RULE_COUNT];  // Отсечений по каждому правилу
+} SearchBounds;
+
+// ============================================================================
+// Функции
+// ============================================================================
+
+/**
+ * Инициализация: буферы на глубины 0..n, enabled - маска правил
+ */
+void search_bounds_init(SearchBounds *bounds, uint32_t n, uint32_t enabled);
+
+/**
+ * Освобождение буферов
+ */
+void search_bounds_destroy(SearchBounds *bounds);
+
+/**
+ * Сброс счетчиков отсечений
+ */
+void search_bounds_reset_stats(SearchBounds *bounds);
+
+/**
+ * Элемент value занял позицию depth (префикс стал длины depth + 1)
+ */
+static inline void search_bounds_push(SearchBounds *bounds, uint32_t depth, value_t value) {
+    bounds->prefix_sum[depth + 1] = bounds->prefix_sum[depth] + value;
+    bounds->prefix_sq[depth + 1] = bounds->prefix_sq[depth] + (bound_wide_t)value * value;
+}
+
+/**
+ * Проверка префикса длины depth: false - его нельзя дополнить до решения
+ * с элементами не больше max_value (отсечение засчитывается правилу)
+ */
+bool search_bounds_feasible(SearchBounds *bounds, uint32_t depth, value_t max_value);
+
+/**
+ * То же при построении сверху вниз: префикс - depth наибольших элементов
+ * в порядке убывания, остальные не больше max_value. Результат монотонен
+ * по max_value и по последнему элементу префикса.
+ */
+bool search_bounds_feasible_top(SearchBounds *bounds, uint32_t depth, value_t max_value);
+
+/**
+ * Наименьший max_value, при котором пустой префикс проходит все
+ * включенные правила: нижняя граница максимума решения
+ * (правила монотонны по max_value - бинарный поиск). Счетчики не меняются.
+ */
+value_t search_bounds_lower_bound(SearchBounds *bounds);
+
+/**
+ * Разбор списка правил через запятую: "all", "none" или названия
+ * Возвращает false при неизвестном названии
+ */
+bool search_bounds_parse(const char *list, uint32_t *enabled);
+
+/**
+ * Сложение счетчиков (сводка параллельного поиска)
+ */
+void search_bounds_merge_stats(SearchBounds *total, const SearchBounds *bounds);
+
+/**
+ * Вывод счетчиков отсечений в лог
+ */
+void search_bounds_log_stats(const SearchBounds *bounds);
+
+#endif // ERDOS_SEARCH_BOUNDS_H
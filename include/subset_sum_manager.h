@@ -1,9 +1,20 @@
 /**
  * subset_sum_manager.h - Менеджер сумм подмножеств
  *
- * Два режима работы:
- * 1. Быстрый (Fast) - хранит все суммы в хеш-таблице, O(1) проверка коллизий
- * 2. Итеративный (Iterative) - не хранит суммы, O(2^N) проверка коллизий
+ * Режимы работы:
+ * 1. Быстрый (Fast) - хранит все суммы в хеш-таблице, O(1) проверка коллизий,
+ *    суммы помечены уровнем добавления, откат элемента - O(1)
+ * 2. Итеративный (Iterative) - суммы не хранятся между узлами, строятся кодом
+ *    Грея и сортируются за O(2^N) на узел, кандидат - проход двумя указателями
+ * 3. Битовый (Bitset) - суммы как плотная битовая маска S,
+ *    коллизия: (S & (S << v)) != 0, добавление: S |= S << v
+ * 4. Отсортированный (Sorted) - суммы глубины k+1 получаются слиянием
+ *    sums_k и sums_k + v, коллизия ищется двумя указателями при слиянии
+ * 5. Разностный (D-set) - битовая маска знаковых сумм T = {Σ ε_i a_i},
+ *    v допустимо iff v ∉ T, проверка - один бит, T' = T ∪ (T+v) ∪ (T-v)
+ * 6. Встреча посередине (MITM) - элементы делятся на две половины, для каждой
+ *    хранятся отсортированные знаковые суммы; v дает коллизию iff v = x + y,
+ *    x и y - знаковые суммы половин (проход двумя указателями)
  */
 
 #ifndef ERDOS_SUBSET_SUM_MANAGER_H
@@ -17,25 +28,47 @@
 // ============================================================================
 
 /**
- * Узел хеш-таблицы
+ * Число слотов в группе пробирования (одно сравнение AVX2 на 4 ключа)
  */
-typedef struct HashNode {
-    value_t value;
-    struct HashNode *next;
-} HashNode;
+#define INT_HASHSET_GROUP 4
+
+/**
+ * Максимальное число уровней хеш-таблицы (глубина хранится в 8 битах метки)
+ */
+#define INT_HASHSET_MAX_LEVELS 256
 
 /**
  * Хеш-таблица для хранения сумм
+ * Открытая адресация с линейным пробированием, емкость - степень двойки.
+ * Слоты просматриваются выровненными группами по INT_HASHSET_GROUP ключей.
+ * Ключ 0 означает никогда не занятый слот (суммы непустых подмножеств
+ * положительны), метка самого значения 0 хранится в zero_stamp.
+ *
+ * Значения добавляются на текущий уровень. Слот помечается меткой уровня
+ * (id << 8) | depth, где id уникален для каждого открытия уровня. Слот жив,
+ * если его уровень открыт и метка совпадает с level_stamp[depth], поэтому
+ * закрытие уровня - O(1): мертвые слоты остаются в таблице, пока в них не
+ * вернется то же значение или таблица не будет перестроена.
  */
 typedef struct {
-    HashNode **buckets;
-    HashNode *pool;      // Пул переиспользуемых узлов
-    size_t bucket_count;
-    size_t size;
+    value_t *keys;       // Слоты (выровнены по группе)
+    uint64_t *stamps;    // Метка уровня для каждого слота (0 = удален)
+    size_t capacity;     // Степень двойки, не меньше INT_HASHSET_GROUP
+    size_t mask;         // capacity - 1
+    size_t size;         // Количество живых значений, включая 0
+    size_t used;         // Занятые слоты (живые и мертвые)
+    uint64_t zero_stamp; // Метка значения 0 (0 = отсутствует)
+    uint64_t next_id;    // Счетчик открытий уровней
+    uint32_t depth;      // Текущий уровень
+    uint64_t level_stamp[INT_HASHSET_MAX_LEVELS];  // Метка открытого уровня
+    size_t level_size[INT_HASHSET_MAX_LEVELS];     // Живых значений на уровне
 } IntHashSet;
 
 /**
- * История добавленных сумм (для отката)
+ * Суммы подмножеств в порядке добавления (быстрый режим)
+ * При k элементах хранится 2^k - 1 ненулевых сумм, суммы, добавленные
+ * элементом с индексом i, занимают [2^i - 1, 2^(i+1) - 1).
+ * Откат - уменьшение count.
  */
 typedef struct {
     value_t *sums;
@@ -43,14 +76,86 @@ typedef struct {
     size_t capacity;
 } SumsHistory;
 
+// ============================================================================
+// Структуры данных для битового режима
+// ============================================================================
+
 /**
- * Стек истории (для каждого добавленного элемента)
+ * Стек битовых слоев
+ * Слой k - битовая маска сумм подмножеств первых k элементов,
+ * бит s установлен, если сумма s достижима (бит 0 - пустое подмножество).
+ * В D-режиме слой k - маска знаковых сумм со смещением Σ_k.
+ * Откат - просто уменьшение глубины, слои не пересчитываются.
+ * Слой строится лениво, при первом обращении к нему. Память слоя k
+ * выделяется при первом построении сразу по границе суммы k различных
+ * элементов не больше max_value и дальше не растет.
  */
 typedef struct {
-    SumsHistory *entries;
-    size_t count;
-    size_t capacity;
-} HistoryStack;
+    uint64_t **layers;         // Слои (по одному на глубину, NULL - не выделен)
+    size_t *layer_capacity;    // Выделено слов в каждом слое
+    size_t layer_count;        // Количество слотов слоев
+    value_t max_value;         // Граница элемента (0 - нет, слои растут удвоением)
+    value_t span;              // Бит на единицу суммы: 1 (суммы) или 2 (D-режим)
+    size_t built_depth;        // Слои 0..built_depth построены (ленивое построение)
+} BitLayers;
+
+// ============================================================================
+// Структуры данных для отсортированного режима
+// ============================================================================
+
+/**
+ * Отсортированные суммы по глубинам
+ * Слой k (2^k сумм, включая 0) хранится с позиции 2^k - 1 одного массива,
+ * поэтому все слои лежат подряд, а откат - просто уменьшение глубины.
+ * Массив выделяется сразу только для небольших N, дальше растет по мере
+ * углубления.
+ */
+typedef struct {
+    value_t *sums;             // Все слои подряд
+    size_t capacity;           // Выделено значений
+} SortedSums;
+
+// ============================================================================
+// Структуры данных для итеративного режима
+// ============================================================================
+
+/**
+ * Временные буферы итеративного режима
+ * sums - отсортированные суммы всех подмножеств текущих элементов,
+ * действительны, пока sorted_size совпадает с размером множества.
+ */
+typedef struct {
+    value_t *sums;             // Отсортированные суммы (2^N)
+    value_t *buffer;           // Буфер поразрядной сортировки
+    size_t capacity;           // Выделено значений в каждом буфере
+    size_t sorted_size;        // Размер множества, для которого построены суммы
+} IterativeScratch;
+
+// ============================================================================
+// Структуры данных для режима встречи посередине
+// ============================================================================
+
+/**
+ * Знаковые суммы одной половины элементов по глубинам
+ * Слой m - отсортированные без повторов значения Σ ε_i a_i (ε_i ∈ {-1, 0, 1})
+ * по первым m элементам половины, не больше 3^m значений. Слои лежат подряд,
+ * откат - уменьшение числа построенных слоев.
+ */
+typedef struct {
+    int64_t *values;           // Все слои подряд
+    size_t capacity;           // Выделено значений
+    size_t *layer_offset;      // Начало слоя m в values
+    size_t *layer_size;        // Размер слоя m
+    size_t layer_capacity;     // Выделено слоев
+    size_t built;              // Построены слои 0..built
+} SignedSumsHalf;
+
+/**
+ * Две половины: элемент с индексом i попадает в половину i % 2
+ */
+typedef struct {
+    SignedSumsHalf halves[2];
+} MeetInMiddle;
 
 // ============================================================================
 // Основная структура менеджера
@@ -65,12 +170,35 @@ typedef struct {
     // Текущие элементы множества
     NumberSet elements;
 
+    // Сумма текущих элементов (максимальная сумма подмножества)
+    value_t elements_sum;
+
     // Для быстрого режима
-    IntHashSet *sums_set;        // Все текущие суммы
-    HistoryStack *history;       // История для отката
+    IntHashSet *sums_set;        // Все текущие суммы, уровень на элемент
+    SumsHistory *history;        // Те же суммы в порядке добавления
+
+    // Для битового и D-режима
+    BitLayers *bit_layers;       // Битовые маски сумм (разностей) по глубинам
+
+    // Для отсортированного режима
+    SortedSums *sorted_sums;     // Отсортированные суммы по глубинам
+
+    // Временные буферы итеративного режима
+    IterativeScratch *iterative;
+
+    // Для режима встречи посередине
+    MeetInMiddle *mitm;          // Знаковые суммы двух половин
 
     // Временная переменная для итеративного режима
     value_t temp_sum;
+
+    // Буферы рассчитаны по (max_elements, max_value): в этих границах
+    // горячий путь не перевыделяет память
+    bool presized;
+
+    // Не удалось выделить память: add_element отклонил элемент без проверки,
+    // ответы менеджера после этого ничего не говорят о множестве
+    bool out_of_memory;
 } SubsetSumManager;
 
 // ============================================================================
@@ -79,8 +207,9 @@ typedef struct {
 
 /**
  * Создание хеш-таблицы
+ * initial_capacity округляется вверх до степени двойки
  */
-IntHashSet* int_hashset_create(size_t initial_buckets);
+IntHashSet* int_hashset_create(size_t initial_capacity);
 
 /**
  * Освобождение хеш-таблицы
@@ -103,6 +232,16 @@ bool int_hashset_contains(const IntHashSet *set, value_t value);
  */
 bool int_hashset_remove(IntHashSet *set, value_t value);
 
+/**
+ * Открытие нового уровня: последующие значения добавляются на него
+ */
+void int_hashset_push_level(IntHashSet *set);
+
+/**
+ * Закрытие текущего уровня за O(1): все значения уровня удаляются
+ */
+void int_hashset_pop_level(IntHashSet *set);
+
 /**
  * Очистка хеш-таблицы
  */
@@ -117,6 +256,17 @@ void int_hashset_clear(IntHashSet *set);
  */
 SubsetSumManager* subset_sum_manager_create(ManagerType type);
 
+/**
+ * Создание менеджера с известными ограничениями задачи
+ * max_elements - максимальное число элементов (0 = неизвестно)
+ * max_value    - верхняя граница элемента, например best_max (0 = неизвестно)
+ * Битовый режим выделяет слои под суммы до max_elements * max_value,
+ * при выходе за границу слои расширяются.
+ */
+SubsetSumManager* subset_sum_manager_create_bounded(ManagerType type,
+                                                    uint32_t max_elements,
+                                                    value_t max_value);
+
 /**
  * Освобождение менеджера
  */
@@ -134,6 +284,33 @@ void subset_sum_manager_reset(SubsetSumManager *manager);
  */
 bool subset_sum_manager_add_element(SubsetSumManager *manager, value_t value);
 
+/**
+ * Поиск следующего допустимого кандидата
+ * Возвращает наименьшее v из [from, limit), которое можно добавить без
+ * коллизий, либо limit, если такого нет. В D-режиме - поиск нулевого бита
+ * по словам маски запрещенных значений (ctz по инверсии). Остальные режимы
+ * не хранят запрещенные значения и возвращают from без проверки:
+ * кандидат проверяется в subset_sum_manager_add_element.
+ */
+value_t subset_sum_manager_next_candidate(SubsetSumManager *manager,
+                                          value_t from, value_t limit);
+
+/**
+ * Хеш множества запрещенных значений T текущих элементов (D-режим)
+ * Префиксы с одинаковыми T одинаково продолжаются. Возвращает false
+ * в режимах, которые не хранят T.
+ */
+bool subset_sum_manager_state_hash(SubsetSumManager *manager, uint64_t *hash);
+
+/**
+ * Поиск предыдущего допустимого кандидата (построение сверху вниз)
+ * Возвращает наибольшее v из [floor, from], которое можно добавить без
+ * коллизий, либо 0, если такого нет (floor >= 1). В D-режиме - поиск
+ * старшего нулевого бита по словам маски, остальные режимы возвращают from.
+ */
+value_t subset_sum_manager_prev_candidate(SubsetSumManager *manager,
+                                          value_t from, value_t floor);
+
 /**
  * Удаление последнего добавленного элемента (откат)
  */
@@ -154,13 +331,23 @@ value_t subset_sum_manager_get_element(const SubsetSumManager *manager, size_t i
  */
 void subset_sum_manager_get_elements(const SubsetSumManager *manager, NumberSet *result);
 
+/**
+ * Число выделений памяти в горячем пути (add/remove/next_candidate)
+ * текущим потоком. Считаются перевыделения буферов сверх размеров,
+ * рассчитанных при создании; разовое выделение битового слоя по его
+ * границе при первом построении не считается. У менеджера с presized
+ * счетчик в границах (max_elements, max_value) не растет.
+ */
+uint64_t subset_sum_manager_hot_allocations(void);
+
 // ============================================================================
 // Внутренние функции (для итеративного режима)
 // ============================================================================
 
 /**
  * Проверка коллизии для нового элемента (итеративный режим)
- * Перебирает все подмножества текущих элементов
+ * Суммы подмножеств текущих элементов перечисляются кодом Грея,
+ * сортируются и проверяются на разность new_value двумя указателями
  */
 bool subset_sum_manager_has_collision_iterative(SubsetSumManager *manager,
                                                 value_t new_value);
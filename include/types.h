@@ -22,6 +22,7 @@
 #define ERDOS_MAX_SET_SIZE 64
 #define ERDOS_DEFAULT_DB_PATH "erdos_results.db"
 #define ERDOS_LOG_INTERVAL_SEC 60
+#define ERDOS_CHECKPOINT_INTERVAL_SEC 300
 
 // ============================================================================
 // Основной числовой тип
@@ -52,9 +53,22 @@ typedef enum {
  */
 typedef enum {
     MANAGER_TYPE_FAST,       // Быстрый (O(2^N) память)
-    MANAGER_TYPE_ITERATIVE   // Итеративный (O(N) память)
+    MANAGER_TYPE_ITERATIVE,  // Итеративный (O(2^N) времени на узел, буферы на 2^N)
+    MANAGER_TYPE_BITSET,     // Битовый (O(N * max) бит, shift-OR по словам)
+    MANAGER_TYPE_SORTED,     // Отсортированные суммы по глубинам (O(2^N) память, слияние)
+    MANAGER_TYPE_DSET,       // Множество разностей сумм (O(N * max) бит, O(1) проверка)
+    MANAGER_TYPE_MITM        // Встреча посередине (O(3^(N/2)) память и время)
 } ManagerType;
 
+/**
+ * Порядок построения множества
+ */
+typedef enum {
+    SEARCH_ORDER_ASCENDING,  // От наименьшего элемента, максимум - последним
+    SEARCH_ORDER_DESCENDING, // От наибольшего: максимум фиксируется первым
+    SEARCH_ORDER_AUTO        // Оба порядка поочередно, результат - первого завершенного
+} SearchOrder;
+
 /**
  * Уровень логирования
  */
@@ -91,6 +105,28 @@ typedef struct {
     time_t timestamp;             // Время завершения
 } SolutionResult;
 
+/**
+ * Контрольная точка поиска (состояние явного стека перебора)
+ * Элементы позиций 0..depth-1 и следующие кандидаты кадров 0..depth
+ * полностью задают позицию поиска, менеджер восстанавливается повторным
+ * добавлением элементов.
+ */
+typedef struct {
+    uint32_t n;                   // Размер множества
+    bool find_all_optimal;        // Режим поиска всех оптимальных
+    NumberSet elements;           // Элементы текущего префикса (depth штук)
+    NumberSet candidates;         // Следующий кандидат каждого кадра (depth + 1)
+    bool entering;                // Текущий узел еще не обработан на входе
+    value_t initial_bound;        // Начальная граница поиска
+    value_t best_max;             // Лучший максимум (0 = решения нет)
+    NumberSet best_set;           // Лучшее найденное множество
+    NumberSet *optimal_sets;      // Найденные оптимальные (find_all_optimal)
+    size_t optimal_count;
+    uint64_t nodes_explored;      // Исследовано узлов
+    double computation_time;      // Время вычисления до точки, сек
+    time_t timestamp;             // Время сохранения
+} SearchCheckpoint;
+
 /**
  * Конфигурация решателя
  */
@@ -102,6 +138,11 @@ typedef struct {
     ManagerType manager_type;      // Тип менеджера сумм
     uint32_t log_interval_sec;     // Интервал логирования
     volatile bool *stop_flag;      // Флаг остановки (для graceful shutdown)
+    uint32_t disabled_bounds;      // Отключенные правила отсечения (маска, 0 = все)
+    SearchOrder order;             // Порядок построения (AUTO выбирается в main)
+    uint32_t nogood_cache_mb;      // Размер кеша тупиков, МБ (0 = выключен)
+    double time_limit_sec;         // Ограничение времени запуска, сек (0 = нет)
+    uint64_t node_limit;           // Ограничение узлов запуска (0 = нет)
 } SolverConfig;
 
 /**
@@ -171,6 +212,19 @@ static inline void number_set_copy(NumberSet *dest, const NumberSet *src) {
     memcpy(dest->elements, src->elements, src->size * sizeof(value_t));
 }
 
+/**
+ * Максимальный элемент множества (0 для пустого)
+ */
+static inline value_t number_set_max(const NumberSet *set) {
+    value_t max_value = 0;
+    for (size_t i = 0; i < set->size; i++) {
+        if (set->elements[i] > max_value) {
+            max_value = set->elements[i];
+        }
+    }
+    return max_value;
+}
+
 /**
  * Получение строкового представления множества
  * Возвращает динамически выделенную строку (нужно освободить)
@@ -226,6 +280,35 @@ static inline void solution_result_clear(SolutionResult *result) {
     number_set_clear(&result->solution_set);
 }
 
+// ============================================================================
+// Функции работы с SearchCheckpoint
+// ============================================================================
+
+/**
+ * Инициализация контрольной точки
+ */
+static inline void search_checkpoint_init(SearchCheckpoint *checkpoint) {
+    memset(checkpoint, 0, sizeof(SearchCheckpoint));
+    number_set_init(&checkpoint->elements, 16);
+    number_set_init(&checkpoint->candidates, 16);
+    number_set_init(&checkpoint->best_set, 16);
+}
+
+/**
+ * Освобождение памяти контрольной точки
+ */
+static inline void search_checkpoint_clear(SearchCheckpoint *checkpoint) {
+    number_set_clear(&checkpoint->elements);
+    number_set_clear(&checkpoint->candidates);
+    number_set_clear(&checkpoint->best_set);
+    for (size_t i = 0; i < checkpoint->optimal_count; i++) {
+        number_set_clear(&checkpoint->optimal_sets[i]);
+    }
+    free(checkpoint->optimal_sets);
+    checkpoint->optimal_sets = NULL;
+    checkpoint->optimal_count = 0;
+}
+
 // ============================================================================
 // Вспомогательные функции
 // ============================================================================
@@ -239,6 +322,15 @@ static inline double get_time_sec(void) {
     return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
 }
 
+/**
+ * Исчерпано ли ограничение запуска (SolverConfig.time_limit_sec, node_limit)
+ */
+static inline bool solver_config_budget_exhausted(const SolverConfig *config,
+                                                  double elapsed, uint64_t nodes) {
+    return (config->time_limit_sec > 0 && elapsed >= config->time_limit_sec) ||
+           (config->node_limit > 0 && nodes >= config->node_limit);
+}
+
 /**
  * Конвертация статуса в строку
  */
@@ -253,4 +345,82 @@ static inline const char* solution_status_to_string(SolutionStatus status) {
     }
 }
 
+/**
+ * Разбор статуса из строки (неизвестный - NO_SOLUTION)
+ */
+static inline SolutionStatus solution_status_from_string(const char *name) {
+    static const SolutionStatus all_statuses[] = {
+        SOLUTION_STATUS_OPTIMAL, SOLUTION_STATUS_FEASIBLE, SOLUTION_STATUS_TIMEOUT,
+        SOLUTION_STATUS_INTERRUPTED
+    };
+    for (size_t i = 0; i < sizeof(all_statuses) / sizeof(all_statuses[0]); i++) {
+        if (strcmp(name, solution_status_to_string(all_statuses[i])) == 0) {
+            return all_statuses[i];
+        }
+    }
+    return SOLUTION_STATUS_NO_SOLUTION;
+}
+
+/**
+ * Конвертация типа менеджера в строку
+ */
+static inline const char* manager_type_to_string(ManagerType type) {
+    switch (type) {
+        case MANAGER_TYPE_FAST:      return "fast";
+        case MANAGER_TYPE_ITERATIVE: return "iterative";
+        case MANAGER_TYPE_BITSET:    return "bitset";
+        case MANAGER_TYPE_SORTED:    return "sorted";
+        case MANAGER_TYPE_DSET:      return "dset";
+        case MANAGER_TYPE_MITM:      return "mitm";
+        default:                     return "unknown";
+    }
+}
+
+/**
+ * Разбор типа менеджера из строки
+ * Возвращает false, если имя неизвестно
+ */
+static inline bool manager_type_from_string(const char *name, ManagerType *type) {
+    static const ManagerType all_types[] = {
+        MANAGER_TYPE_FAST, MANAGER_TYPE_ITERATIVE, MANAGER_TYPE_BITSET, MANAGER_TYPE_SORTED,
+        MANAGER_TYPE_DSET, MANAGER_TYPE_MITM
+    };
+    for (size_t i = 0; i < sizeof(all_types) / sizeof(all_types[0]); i++) {
+        if (strcmp(name, manager_type_to_string(all_types[i])) == 0) {
+            *type = all_types[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Конвертация порядка построения в строку
+ */
+static inline const char* search_order_to_string(SearchOrder order) {
+    switch (order) {
+        case SEARCH_ORDER_ASCENDING:  return "ascending";
+        case SEARCH_ORDER_DESCENDING: return "descending";
+        case SEARCH_ORDER_AUTO:       return "auto";
+        default:                      return "unknown";
+    }
+}
+
+/**
+ * Разбор порядка построения из строки
+ * Возвращает false, если название неизвестно
+ */
+static inline bool search_order_from_string(const char *name, SearchOrder *order) {
+    static const SearchOrder all_orders[] = {
+        SEARCH_ORDER_ASCENDING, SEARCH_ORDER_DESCENDING, SEARCH_ORDER_AUTO
+    };
+    for (size_t i = 0; i < sizeof(all_orders) / sizeof(all_orders[0]); i++) {
+        if (strcmp(name, search_order_to_string(all_orders[i])) == 0) {
+            *order = all_orders[i];
+            return true;
+        }
+    }
+    return false;
+}
+
 #endif // ERDOS_TYPES_H
@@ -4,10 +4,13 @@
  * Использует нативную арифметику uint64_t.
  */
 
+#include <assert.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <stdatomic.h>
 #include "../include/backtrack_solver.h"
+#include "../include/external_sums.h"
 #include "../include/logger.h"
 
 // ============================================================================
@@ -20,21 +23,38 @@ value_t compute_initial_bound(uint32_t n) {
     return (1ULL << (n - 1)) + 1;
 }
 
-bool is_valid_b_sequence(const NumberSet *set) {
-    if (set->size == 0) return true;
+BSequenceCheck check_b_sequence(const NumberSet *set) {
+    if (set->size == 0) return B_SEQUENCE_VALID;
+
+    // 2^N сумм больших множеств не держим в памяти целиком - внешняя
+    // проверка; до B_SEQUENCE_IN_MEMORY_MAX короткими прогонами
+    if (set->size > B_SEQUENCE_SORTED_MAX) {
+        ExternalSumsOptions options = { .temp_dir = NULL, .run_log2 = B_SEQUENCE_SORTED_MAX };
+        switch (external_sums_check(set->elements, set->size,
+                                    set->size <= B_SEQUENCE_IN_MEMORY_MAX ? &options : NULL)) {
+            case EXTERNAL_SUMS_DISTINCT:  return B_SEQUENCE_VALID;
+            case EXTERNAL_SUMS_COLLISION: return B_SEQUENCE_INVALID;
+            default:                      return B_SEQUENCE_UNKNOWN;
+        }
+    }
 
     // Создаем временный менеджер для проверки
-    SubsetSumManager *manager = subset_sum_manager_create(MANAGER_TYPE_FAST);
+    SubsetSumManager *manager = subset_sum_manager_create_bounded(MANAGER_TYPE_SORTED,
+                                                                  (uint32_t)set->size, 0);
 
+    BSequenceCheck check = B_SEQUENCE_VALID;
     for (size_t i = 0; i < set->size; i++) {
         if (!subset_sum_manager_add_element(manager, set->elements[i])) {
-            subset_sum_manager_destroy(manager);
-            return false;
+            check = B_SEQUENCE_INVALID;
+            break;
         }
     }
+    if (manager->out_of_memory) {
+        check = B_SEQUENCE_UNKNOWN;
+    }
 
     subset_sum_manager_destroy(manager);
-    return true;
+    return check;
 }
 
 // ============================================================================
@@ -47,29 +67,72 @@ BacktrackSolver* backtrack_solver_create(const SolverConfig *config) {
     // Копируем конфигурацию
     solver->config = *config;
 
-    // Определяем тип менеджера: быстрый для N < 25, итеративный для N >= 25
+    // Определяем тип менеджера: режимы с O(2^N) памятью только для N < 25,
+    // дальше встреча посередине (O(3^(N/2))), после N > 40 - итеративный
     ManagerType manager_type = config->manager_type;
-    if (config->n >= 25 && manager_type == MANAGER_TYPE_FAST) {
-        LOG_WARNING("N=%u слишком велико для быстрого режима, переключаемся на итеративный",
+    if (config->n >= 25 && manager_type != MANAGER_TYPE_ITERATIVE &&
+        manager_type != MANAGER_TYPE_MITM) {
+        LOG_WARNING("N=%u слишком велико для быстрого режима, переключаемся на встречу посередине",
+                    config->n);
+        manager_type = MANAGER_TYPE_MITM;
+    }
+    if (config->n > 40 && manager_type == MANAGER_TYPE_MITM) {
+        LOG_WARNING("N=%u слишком велико для встречи посередине, переключаемся на итеративный",
                     config->n);
         manager_type = MANAGER_TYPE_ITERATIVE;
     }
 
-    solver->manager = subset_sum_manager_create(manager_type);
+    // Элементы решения не превышают начальной границы
+    value_t max_value = config->initial_bound > 0 ?
+                        config->initial_bound : compute_initial_bound(config->n);
+    solver->manager = subset_sum_manager_create_bounded(manager_type, config->n, max_value);
 
     // Инициализируем лучшее решение
     solver->best_max = 0;
     number_set_init(&solver->best_solution, config->n);
     solver->has_solution = false;
+    number_set_init(&solver->incumbent, config->n);
+    solver->decision_max = 0;
+    solver->stop_on_first = config->first_only;
 
     // Инициализируем массив всех оптимальных решений
     solver->all_optimal_solutions = NULL;
     solver->optimal_count = 0;
     solver->optimal_capacity = 0;
+    solver->optimal_callback = NULL;
+    solver->optimal_user_data = NULL;
+    solver->optimal_streamed = 0;
+    number_set_init(&solver->stream_set, config->n);
 
     // Инициализируем статистику
     memset(&solver->stats, 0, sizeof(SearchStats));
 
+    // Последовательный поиск: общей границы нет
+    solver->shared_best_max = NULL;
+    solver->shared_lower_bound = NULL;
+
+    // Кеш тупиков нужен только построению снизу
+    solver->nogood_cache = config->order != SEARCH_ORDER_DESCENDING ?
+                           nogood_cache_create(config->nogood_cache_mb) : NULL;
+    solver->owns_nogood_cache = solver->nogood_cache != NULL;
+    solver->nogood_hits = 0;
+    solver->nogood_stores = 0;
+
+    // Явный стек поиска: кадр на каждую глубину 0..N
+    solver->stack.frames = calloc((size_t)config->n + 1, sizeof(SearchFrame));
+    solver->stack.depth = 0;
+    solver->stack.base_depth = 0;
+    solver->stack.entering = false;
+    solver->stack.active = false;
+    solver->stack.complete = false;
+    solver->run_time = 0.0;
+    solver->budget_start = 0.0;
+    solver->budget_nodes_start = 0;
+    solver->budget_exhausted = false;
+    solver->hot_allocations_start = 0;
+    search_bounds_init(&solver->bounds, config->n,
+                       BOUND_RULES_ALL & ~config->disabled_bounds);
+
     // Callbacks
     solver->solution_callback = NULL;
     solver->progress_callback = NULL;
@@ -83,10 +146,17 @@ void backtrack_solver_destroy(BacktrackSolver *solver) {
 
     subset_sum_manager_destroy(solver->manager);
     number_set_clear(&solver->best_solution);
+    number_set_clear(&solver->incumbent);
+    number_set_clear(&solver->stream_set);
+    free(solver->stack.frames);
+    search_bounds_destroy(&solver->bounds);
+    if (solver->owns_nogood_cache) {
+        nogood_cache_destroy(solver->nogood_cache);
+    }
 
     // Освобождаем все оптимальные решения
     if (solver->all_optimal_solutions) {
-        for (size_t i = 0; i < solver->optimal_count; i++) {
+        for (size_t i = 0; i < solver->optimal_capacity; i++) {
             number_set_clear(&solver->all_optimal_solutions[i]);
         }
         free(solver->all_optimal_solutions);
@@ -109,16 +179,39 @@ void backtrack_solver_set_progress_callback(BacktrackSolver *solver,
     solver->callback_user_data = user_data;
 }
 
+void backtrack_solver_set_optimal_callback(BacktrackSolver *solver,
+                                           OptimalSetCallback callback,
+                                           void *user_data) {
+    solver->optimal_callback = callback;
+    solver->optimal_user_data = user_data;
+}
+
 // ============================================================================
 // Основной алгоритм backtracking
 // ============================================================================
 
+/**
+ * Текущее множество менеджера по возрастанию
+ * Сверху вниз элементы добавляются по убыванию - разворачиваем, чтобы
+ * одно множество сохранялось одинаково при любом порядке построения.
+ */
+static void get_current_set(BacktrackSolver *solver, NumberSet *set) {
+    subset_sum_manager_get_elements(solver->manager, set);
+    if (solver->config.order == SEARCH_ORDER_DESCENDING && solver->decision_max == 0) {
+        for (size_t i = 0, j = set->size; i + 1 < j; i++, j--) {
+            value_t tmp = set->elements[i];
+            set->elements[i] = set->elements[j - 1];
+            set->elements[j - 1] = tmp;
+        }
+    }
+}
+
 /**
  * Сохранение текущего решения как нового лучшего
  */
 static void save_best_solution(BacktrackSolver *solver) {
     // Копируем текущие элементы как лучшее решение
-    subset_sum_manager_get_elements(solver->manager, &solver->best_solution);
+    get_current_set(solver, &solver->best_solution);
 
     // Находим максимальный элемент
     solver->best_max = 0;
@@ -132,6 +225,17 @@ static void save_best_solution(BacktrackSolver *solver) {
     solver->stats.best_max = solver->best_max;
     solver->stats.solutions_found++;
 
+    // Публикуем максимум для остальных потоков (атомарный минимум, 0 = нет)
+    if (solver->shared_best_max) {
+        value_t shared = atomic_load_explicit(solver->shared_best_max, memory_order_relaxed);
+        while ((shared == 0 || solver->best_max < shared) &&
+               !atomic_compare_exchange_weak_explicit(solver->shared_best_max, &shared,
+                                                      solver->best_max,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+        }
+    }
+
     // Вызываем callback
     if (solver->solution_callback) {
         solver->solution_callback(solver->config.n, solver->best_max,
@@ -142,9 +246,9 @@ static void save_best_solution(BacktrackSolver *solver) {
 }
 
 /**
- * Добавление решения в список оптимальных
+ * Место под следующее решение в списке оптимальных
  */
-static void add_optimal_solution(BacktrackSolver *solver) {
+static NumberSet* next_optimal_slot(BacktrackSolver *solver) {
     if (solver->optimal_count >= solver->optimal_capacity) {
         size_t new_capacity = solver->optimal_capacity == 0 ? 16 : solver->optimal_capacity * 2;
         solver->all_optimal_solutions = realloc(solver->all_optimal_solutions,
@@ -155,9 +259,27 @@ static void add_optimal_solution(BacktrackSolver *solver) {
         solver->optimal_capacity = new_capacity;
     }
 
-    subset_sum_manager_get_elements(solver->manager,
-                                    &solver->all_optimal_solutions[solver->optimal_count]);
-    solver->optimal_count++;
+    return &solver->all_optimal_solutions[solver->optimal_count++];
+}
+
+/**
+ * Выдача множества в callback оптимальных
+ */
+static void stream_optimal_set(BacktrackSolver *solver, const NumberSet *set) {
+    solver->optimal_callback(solver->config.n, set, solver->optimal_user_data);
+    solver->optimal_streamed++;
+}
+
+/**
+ * Добавление решения в список оптимальных (или выдача потоком)
+ */
+static void add_optimal_solution(BacktrackSolver *solver) {
+    if (solver->optimal_callback) {
+        get_current_set(solver, &solver->stream_set);
+        stream_optimal_set(solver, &solver->stream_set);
+        return;
+    }
+    get_current_set(solver, next_optimal_slot(solver));
 }
 
 /**
@@ -168,141 +290,426 @@ static void check_progress(BacktrackSolver *solver) {
     if (now - solver->stats.last_log_time >= solver->config.log_interval_sec) {
         solver->stats.last_log_time = now;
 
-        double elapsed = difftime(now, solver->stats.start_time);
-        log_progress(solver->config.n, solver->stats.nodes_explored, elapsed,
-                     solver->stats.current_depth, solver->stats.best_max);
-
+        // Callback заменяет стандартный вывод (параллельный поиск
+        // собирает прогресс всех потоков в одну строку)
         if (solver->progress_callback) {
             solver->progress_callback(&solver->stats, solver->callback_user_data);
+        } else {
+            double elapsed = difftime(now, solver->stats.start_time);
+            log_progress(solver->config.n, solver->stats.nodes_explored, elapsed,
+                         solver->stats.current_depth, solver->stats.best_max);
         }
     }
 }
 
 /**
- * Рекурсивная функция backtracking
- *
- * @param solver     Контекст решателя
- * @param depth      Текущая глубина (количество уже добавленных элементов)
- * @param min_next   Минимальное значение следующего элемента
+ * Текущий лучший максимум с учетом других потоков (0 = решения нет)
+ */
+static inline value_t current_best_max(const BacktrackSolver *solver) {
+    value_t best = solver->has_solution ? solver->best_max : 0;
+    if (solver->shared_best_max) {
+        value_t shared = atomic_load_explicit(solver->shared_best_max, memory_order_relaxed);
+        if (shared != 0 && (best == 0 || shared < best)) {
+            best = shared;
+        }
+    }
+    return best;
+}
+
+/**
+ * Завершение перебора, если лучший максимум достиг доказанной нижней
+ * границы (решение оптимально); поиск всех оптимальных продолжается
  */
-static void backtrack(BacktrackSolver *solver, uint32_t depth, value_t min_next) {
-    // Проверка флага остановки
-    if (solver->config.stop_flag && *solver->config.stop_flag) {
+static inline void stop_at_lower_bound(BacktrackSolver *solver) {
+    if (!solver->shared_lower_bound || solver->config.find_all_optimal) {
         return;
     }
 
-    // Увеличиваем счетчик узлов
-    solver->stats.nodes_explored++;
-    solver->stats.current_depth = depth;
+    value_t lower = atomic_load_explicit(solver->shared_lower_bound, memory_order_relaxed);
+    value_t best = current_best_max(solver);
+    if (lower != 0 && best != 0 && best <= lower) {
+        solver->stack.active = false;
+        solver->stack.complete = true;
+    }
+}
 
-    // Периодическая проверка прогресса
-    uint64_t check_mask = solver->stats.nodes_explored > 100000 ? 0xFFFF : 0x3FF;
-    if ((solver->stats.nodes_explored & check_mask) == 0) {
-        check_progress(solver);
+/**
+ * Исключительная верхняя граница кандидата на текущей глубине
+ * Без решения - начальная граница, с решением - отсечение 2:
+ * candidate + remaining < best_max (в режиме всех оптимальных <=,
+ * чтобы найти и множества с равным максимумом)
+ */
+static inline value_t candidate_limit(const BacktrackSolver *solver, uint32_t remaining) {
+    value_t limit;
+    if (solver->decision_max != 0) {
+        // Распознавание: все элементы не больше M
+        limit = solver->decision_max + 1;
+    } else {
+        value_t best = current_best_max(solver);
+        if (best == 0) {
+            return solver->config.initial_bound;
+        }
+        limit = solver->config.find_all_optimal ? best + 1 : best;
     }
+    return limit > remaining ? limit - remaining : 0;
+}
 
-    // Базовый случай: найдено полное множество
-    if (depth == solver->config.n) {
-        // Находим максимум текущего решения
-        value_t current_max = 0;
-        size_t size = subset_sum_manager_size(solver->manager);
-        for (size_t i = 0; i < size; i++) {
-            value_t elem = subset_sum_manager_get_element(solver->manager, i);
-            if (elem > current_max) {
-                current_max = elem;
-            }
+/**
+ * Обработка полного множества (глубина N)
+ */
+static void handle_complete_set(BacktrackSolver *solver) {
+    // Находим максимум текущего решения
+    value_t current_max = 0;
+    size_t size = subset_sum_manager_size(solver->manager);
+    for (size_t i = 0; i < size; i++) {
+        value_t elem = subset_sum_manager_get_element(solver->manager, i);
+        if (elem > current_max) {
+            current_max = elem;
         }
+    }
 
-        if (!solver->config.find_all_optimal) {
-            // Обычный режим - только первое лучшее решение
-            if (current_max < solver->best_max) {
-                save_best_solution(solver);
-            }
-        } else {
-            // Режим поиска всех оптимальных
-            if (!solver->has_solution || current_max < solver->best_max) {
-                // Новый лучший максимум - очищаем старые решения
-                solver->optimal_count = 0;
-                save_best_solution(solver);
-                add_optimal_solution(solver);
-            } else if (current_max == solver->best_max) {
-                // Равный максимум - добавляем к списку
-                add_optimal_solution(solver);
-                solver->stats.solutions_found++;
-                if (solver->optimal_count <= 10) {
-                    LOG_INFO("Found another optimal: N=%u, total=%zu",
-                             solver->config.n, solver->optimal_count);
-                }
+    value_t best = current_best_max(solver);
+
+    if (!solver->config.find_all_optimal) {
+        // Обычный режим - только первое лучшее решение
+        if (best == 0 || current_max < best) {
+            save_best_solution(solver);
+        }
+    } else {
+        // Режим поиска всех оптимальных; общий максимум может прийти без
+        // своего решения - первое свое решение с ним тоже новое лучшее
+        if (!solver->has_solution || best == 0 || current_max < best ||
+            current_max < solver->best_max) {
+            // Новый лучший максимум - очищаем старые решения
+            solver->optimal_count = 0;
+            solver->optimal_streamed = 0;
+            save_best_solution(solver);
+            add_optimal_solution(solver);
+        } else if (current_max == solver->best_max) {
+            // Равный максимум - добавляем к списку
+            add_optimal_solution(solver);
+            solver->stats.solutions_found++;
+            size_t total = backtrack_solver_optimal_total(solver);
+            if (total <= 10) {
+                LOG_INFO("Found another optimal: N=%u, total=%zu",
+                         solver->config.n, total);
             }
         }
+    }
+}
 
-        return;
+/**
+ * Пересчет состояния отсечений для префикса, загруженного в менеджер
+ */
+static void sync_bounds(BacktrackSolver *solver, uint32_t depth) {
+    solver->bounds.prefix_sum[0] = 0;
+    solver->bounds.prefix_sq[0] = 0;
+    for (uint32_t d = 0; d < depth; d++) {
+        search_bounds_push(&solver->bounds, d,
+                           subset_sum_manager_get_element(solver->manager, d));
     }
+}
 
-    // Отсечение 1: минимально возможный максимум
-    uint32_t remaining = solver->config.n - depth - 1;
-    value_t min_possible = min_next + remaining;
+/**
+ * Установка корня поиска: узел глубины depth с первым кандидатом min_next
+ * Менеджер уже содержит depth элементов префикса.
+ */
+static void search_stack_init(BacktrackSolver *solver, uint32_t depth, value_t min_next) {
+    SearchStack *stack = &solver->stack;
+    sync_bounds(solver, depth);
+    stack->base_depth = depth;
+    stack->depth = depth;
+    stack->frames[depth].next_candidate = min_next;
+    stack->frames[depth].nogood_key = 0;
+    stack->entering = true;
+    stack->active = true;
+    stack->complete = false;
+}
+
+/**
+ * Выход из текущего узла: откат его элемента и возврат к родителю
+ */
+static inline void search_stack_leave(BacktrackSolver *solver) {
+    SearchStack *stack = &solver->stack;
 
-    if (solver->has_solution && min_possible >= solver->best_max) {
-        return;  // Отсечение: не можем улучшить текущий лучший результат
+    if (stack->depth == stack->base_depth) {
+        stack->active = false;
+        stack->complete = true;
+        return;
     }
 
-    // Перебор кандидатов
-    value_t candidate = min_next;
+    subset_sum_manager_remove_last(solver->manager);
+    stack->depth--;
 
-    // Цикл пока кандидат меньше верхней границы
-    for (;;) {
+    // В режиме first_only останавливаемся после первого найденного решения
+    if (solver->stop_on_first && solver->stats.solutions_found > 0) {
+        stack->active = false;
+    }
+}
+
+/**
+ * Перебор с возвратом на явном стеке
+ *
+ * frames[d].next_candidate - наименьший еще не рассмотренный кандидат на
+ * позицию d, менеджер содержит элементы позиций 0..depth-1. Узел глубины
+ * depth сначала обрабатывается на входе (счетчик, решение, отсечение 1),
+ * затем перебирает кандидатов; спуск - добавление элемента и вход в узел
+ * depth + 1, возврат - откат элемента. Состояние целиком лежит в стеке,
+ * поэтому поиск можно приостановить в любом узле и продолжить позже.
+ *
+ * Возвращает false, если поиск приостановлен (бюджет узлов или остановка)
+ */
+static bool search_stack_run(BacktrackSolver *solver, uint64_t node_budget) {
+    SearchStack *stack = &solver->stack;
+    SearchFrame *frames = stack->frames;
+    uint32_t n = solver->config.n;
+    uint64_t node_limit = node_budget > UINT64_MAX - solver->stats.nodes_explored ?
+                          UINT64_MAX : solver->stats.nodes_explored + node_budget;
+
+    while (stack->active) {
         // Проверка флага остановки
         if (solver->config.stop_flag && *solver->config.stop_flag) {
-            return;
+            return false;
         }
 
-        // Динамическая проверка верхней границы
-        if (solver->has_solution) {
-            if (candidate >= solver->best_max) {
-                break;
+        uint32_t depth = stack->depth;
+
+        if (stack->entering) {
+            // Бюджет исчерпан - пауза перед входом в узел
+            if (solver->stats.nodes_explored >= node_limit) {
+                return false;
             }
-        } else {
-            if (candidate >= solver->config.initial_bound) {
-                break;
+            stack->entering = false;
+
+            // Увеличиваем счетчик узлов
+            solver->stats.nodes_explored++;
+            solver->stats.current_depth = depth;
+
+            // Периодическая проверка прогресса
+            uint64_t check_mask = solver->stats.nodes_explored > 100000 ? 0xFFFF : 0x3FF;
+            if ((solver->stats.nodes_explored & check_mask) == 0) {
+                check_progress(solver);
+                stop_at_lower_bound(solver);
+                if (!stack->active) {
+                    continue;
+                }
+            }
+
+            // Базовый случай: найдено полное множество
+            if (depth == n) {
+                handle_complete_set(solver);
+                search_stack_leave(solver);
+                stop_at_lower_bound(solver);
+                continue;
+            }
+
+            // Отсечение 1: минимально возможный максимум
+            // next_candidate + remaining >= best_max (через границу кандидата)
+            if (frames[depth].next_candidate >= candidate_limit(solver, n - depth - 1)) {
+                search_stack_leave(solver);
+                continue;
+            }
+
+            // Распознавание: M - разность сумм подмножеств префикса, то же
+            // будет и у любого продолжения - M не может стать последним
+            // элементом (фильтр есть только у DSET); последняя позиция - M
+            if (solver->decision_max != 0) {
+                value_t decision_max = solver->decision_max;
+                if (subset_sum_manager_next_candidate(solver->manager, decision_max,
+                                                      decision_max + 1) != decision_max) {
+                    search_stack_leave(solver);
+                    continue;
+                }
+                if (depth == n - 1) {
+                    frames[depth].next_candidate = decision_max;
+                }
+            }
+
+            // Отсечение 3: необходимые условия на префикс (search_bounds.h)
+            if (!search_bounds_feasible(&solver->bounds, depth,
+                                        candidate_limit(solver, 0) - 1)) {
+                search_stack_leave(solver);
+                continue;
+            }
+
+            // Отсечение 4: то же T уже было тупиком при границе не ниже текущей
+            frames[depth].nogood_key = 0;
+            uint64_t state;
+            if (solver->nogood_cache && solver->decision_max == 0 &&
+                n - depth >= NOGOOD_MIN_REMAINING &&
+                subset_sum_manager_state_hash(solver->manager, &state)) {
+                uint64_t key = nogood_cache_key(state, depth, frames[depth].next_candidate);
+                if (nogood_cache_lookup(solver->nogood_cache, key, candidate_limit(solver, 0))) {
+                    solver->nogood_hits++;
+                    search_stack_leave(solver);
+                    continue;
+                }
+                frames[depth].nogood_key = key;
+                frames[depth].solutions_at_entry = solver->stats.solutions_found;
             }
         }
 
-        // Отсечение 2: candidate + remaining >= best_max
-        if (solver->has_solution && (candidate + remaining) >= solver->best_max) {
-            break;  // Все дальнейшие кандидаты еще хуже
+        // Динамическая верхняя граница кандидата (исключительная)
+        value_t limit = candidate_limit(solver, n - depth - 1);
+
+        // Переход сразу к следующему допустимому кандидату
+        value_t candidate = subset_sum_manager_next_candidate(solver->manager,
+                                                              frames[depth].next_candidate,
+                                                              limit);
+        if (candidate >= limit) {
+            // Поддерево перебрано без решений - тупик при текущей границе
+            if (frames[depth].nogood_key != 0 &&
+                solver->stats.solutions_found == frames[depth].solutions_at_entry) {
+                nogood_cache_store(solver->nogood_cache, frames[depth].nogood_key,
+                                   candidate_limit(solver, 0));
+                solver->nogood_stores++;
+            }
+
+            // Все дальнейшие кандидаты еще хуже
+            search_stack_leave(solver);
+            continue;
         }
+        frames[depth].next_candidate = candidate + 1;
 
-        // Попытка добавить кандидата
+        // Попытка добавить кандидата: успех - спуск в узел depth + 1
         if (subset_sum_manager_add_element(solver->manager, candidate)) {
-            // Успешно добавлен - рекурсивный вызов
-            backtrack(solver, depth + 1, candidate + 1);
+            search_bounds_push(&solver->bounds, depth, candidate);
+            stack->depth = depth + 1;
+            frames[depth + 1].next_candidate = candidate + 1;
+            stack->entering = true;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Перебор сверху вниз (SEARCH_ORDER_DESCENDING)
+ *
+ * Позиция 0 - наибольший элемент, его значения перебираются по
+ * возрастанию, поэтому первое найденное решение сразу оптимально.
+ * Остальные позиции перебираются по убыванию: frames[d].next_candidate -
+ * наибольший еще не рассмотренный кандидат, он не меньше N - d (ниже
+ * должны поместиться оставшиеся различные положительные элементы).
+ * Узел отбрасывается по границам для наибольших элементов
+ * (search_bounds_feasible_top); граница монотонна по последнему элементу,
+ * поэтому меньшие кандидаты родителя тоже отбрасываются - родитель
+ * завершается сразу.
+ */
+static bool search_stack_run_descending(BacktrackSolver *solver, uint64_t node_budget) {
+    SearchStack *stack = &solver->stack;
+    SearchFrame *frames = stack->frames;
+    uint32_t n = solver->config.n;
+    uint64_t node_limit = node_budget > UINT64_MAX - solver->stats.nodes_explored ?
+                          UINT64_MAX : solver->stats.nodes_explored + node_budget;
+
+    while (stack->active) {
+        // Проверка флага остановки
+        if (solver->config.stop_flag && *solver->config.stop_flag) {
+            return false;
+        }
+
+        uint32_t depth = stack->depth;
+
+        if (stack->entering) {
+            // Бюджет исчерпан - пауза перед входом в узел
+            if (solver->stats.nodes_explored >= node_limit) {
+                return false;
+            }
+            stack->entering = false;
+
+            solver->stats.nodes_explored++;
+            solver->stats.current_depth = depth;
+
+            uint64_t check_mask = solver->stats.nodes_explored > 100000 ? 0xFFFF : 0x3FF;
+            if ((solver->stats.nodes_explored & check_mask) == 0) {
+                check_progress(solver);
+                stop_at_lower_bound(solver);
+                if (!stack->active) {
+                    continue;
+                }
+            }
 
-            // Откат
-            subset_sum_manager_remove_last(solver->manager);
+            if (depth == n) {
+                handle_complete_set(solver);
+                search_stack_leave(solver);
+                stop_at_lower_bound(solver);
+                continue;
+            }
 
-            // В режиме first_only останавливаемся после первого решения
-            if (solver->config.first_only && solver->has_solution) {
-                return;
+            // Отсечение по наибольшим элементам: остальные меньше последнего
+            if (depth > 0) {
+                value_t smallest = subset_sum_manager_get_element(solver->manager, depth - 1);
+                if (!search_bounds_feasible_top(&solver->bounds, depth, smallest - 1)) {
+                    if (depth > 1) {
+                        frames[depth - 1].next_candidate = 0;
+                    }
+                    search_stack_leave(solver);
+                    continue;
+                }
             }
         }
 
-        candidate++;
+        value_t candidate;
+        if (depth == 0) {
+            // Максимум - по возрастанию под текущей границей
+            value_t limit = candidate_limit(solver, 0);
+            candidate = subset_sum_manager_next_candidate(solver->manager,
+                                                          frames[0].next_candidate, limit);
+            if (candidate >= limit) {
+                search_stack_leave(solver);
+                continue;
+            }
+            frames[0].next_candidate = candidate + 1;
+        } else {
+            // Максимум уже не лучше найденного решения
+            if (subset_sum_manager_get_element(solver->manager, 0) >=
+                candidate_limit(solver, 0)) {
+                search_stack_leave(solver);
+                continue;
+            }
+            candidate = subset_sum_manager_prev_candidate(solver->manager,
+                                                          frames[depth].next_candidate,
+                                                          n - depth);
+            if (candidate == 0) {
+                search_stack_leave(solver);
+                continue;
+            }
+            frames[depth].next_candidate = candidate - 1;
+        }
+
+        if (subset_sum_manager_add_element(solver->manager, candidate)) {
+            search_bounds_push(&solver->bounds, depth, candidate);
+            stack->depth = depth + 1;
+            frames[depth + 1].next_candidate = candidate - 1;
+            stack->entering = true;
+        }
     }
+
+    return true;
 }
 
 // ============================================================================
 // Публичные функции решения
 // ============================================================================
 
-void backtrack_solver_solve(BacktrackSolver *solver, SolutionResult *result) {
-    // Инициализация
+void backtrack_solver_prepare(BacktrackSolver *solver) {
     solver->has_solution = false;
+    solver->decision_max = 0;
+    solver->stop_on_first = solver->config.first_only;
+    solver->optimal_count = 0;
+    solver->optimal_streamed = 0;
     solver->stats.nodes_explored = 0;
     solver->stats.solutions_found = 0;
     solver->stats.start_time = time(NULL);
     solver->stats.last_log_time = solver->stats.start_time;
     solver->stats.current_depth = 0;
+    search_bounds_reset_stats(&solver->bounds);
+    solver->nogood_hits = 0;
+    solver->nogood_stores = 0;
+    solver->budget_start = get_time_sec();
+    solver->budget_nodes_start = 0;
+    solver->budget_exhausted = false;
 
     // Устанавливаем начальную границу
     if (solver->config.initial_bound == 0) {
@@ -312,9 +719,91 @@ void backtrack_solver_solve(BacktrackSolver *solver, SolutionResult *result) {
     solver->best_max = solver->config.initial_bound;
     solver->stats.best_max = solver->config.initial_bound;
 
-    log_start(solver->config.n, solver->config.initial_bound);
+    // Инкумбент - текущее лучшее решение с самого начала
+    if (solver->incumbent.size > 0) {
+        number_set_copy(&solver->best_solution, &solver->incumbent);
+        solver->best_max = number_set_max(&solver->incumbent);
+        solver->stats.best_max = solver->best_max;
+        solver->has_solution = true;
+    }
 
-    double start_time = get_time_sec();
+    subset_sum_manager_reset(solver->manager);
+}
+
+void backtrack_solver_set_incumbent(BacktrackSolver *solver, const NumberSet *set) {
+    number_set_copy(&solver->incumbent, set);
+}
+
+void backtrack_solver_set_nogood_cache(BacktrackSolver *solver, NogoodCache *cache) {
+    if (solver->owns_nogood_cache) {
+        nogood_cache_destroy(solver->nogood_cache);
+    }
+    solver->nogood_cache = cache;
+    solver->owns_nogood_cache = false;
+}
+
+void backtrack_solver_set_shared_bound(BacktrackSolver *solver,
+                                       _Atomic value_t *shared_best_max) {
+    solver->shared_best_max = shared_best_max;
+}
+
+void backtrack_solver_set_lower_bound(BacktrackSolver *solver,
+                                      const _Atomic value_t *lower_bound) {
+    solver->shared_lower_bound = lower_bound;
+}
+
+bool backtrack_solver_load_prefix(BacktrackSolver *solver, const value_t *prefix,
+                                  uint32_t depth) {
+    subset_sum_manager_reset(solver->manager);
+    for (uint32_t i = 0; i < depth; i++) {
+        if (!subset_sum_manager_add_element(solver->manager, prefix[i])) {
+            subset_sum_manager_reset(solver->manager);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool backtrack_solver_next_child(BacktrackSolver *solver, value_t from, value_t *child) {
+    uint32_t depth = (uint32_t)subset_sum_manager_size(solver->manager);
+    if (depth >= solver->config.n) {
+        return false;
+    }
+
+    uint32_t remaining = solver->config.n - depth - 1;
+    value_t candidate = from;
+    for (;;) {
+        if (solver->config.stop_flag && *solver->config.stop_flag) {
+            return false;
+        }
+
+        value_t limit = candidate_limit(solver, remaining);
+        candidate = subset_sum_manager_next_candidate(solver->manager, candidate, limit);
+        if (candidate >= limit) {
+            return false;
+        }
+        if (subset_sum_manager_add_element(solver->manager, candidate)) {
+            *child = candidate;
+            return true;
+        }
+        candidate++;
+    }
+}
+
+void backtrack_solver_search_subtree(BacktrackSolver *solver) {
+    uint32_t depth = (uint32_t)subset_sum_manager_size(solver->manager);
+    value_t min_next = depth > 0 ?
+                       subset_sum_manager_get_element(solver->manager, depth - 1) + 1 : 1;
+    search_stack_init(solver, depth, min_next);
+    search_stack_run(solver, UINT64_MAX);
+}
+
+void backtrack_solver_begin(BacktrackSolver *solver) {
+    backtrack_solver_prepare(solver);
+    solver->run_time = 0.0;
+    solver->hot_allocations_start = subset_sum_manager_hot_allocations();
+
+    log_start(solver->config.n, solver->config.initial_bound);
 
     // Особый случай для N=1
     if (solver->config.n == 1) {
@@ -322,46 +811,263 @@ void backtrack_solver_solve(BacktrackSolver *solver, SolutionResult *result) {
         solver->best_solution.size = 1;
         solver->best_solution.elements[0] = 1;
         solver->has_solution = true;
+        if (solver->config.find_all_optimal) {
+            if (solver->optimal_callback) {
+                stream_optimal_set(solver, &solver->best_solution);
+            } else {
+                number_set_copy(next_optimal_slot(solver), &solver->best_solution);
+            }
+        }
+        solver->stack.active = false;
+        solver->stack.complete = true;
         log_solution_found(solver->config.n, solver->best_max, &solver->best_solution);
+        return;
+    }
+
+    // Сверху вниз максимум перебирается от нижней границы правил отсечения
+    if (solver->config.order == SEARCH_ORDER_DESCENDING) {
+        search_stack_init(solver, 0, search_bounds_lower_bound(&solver->bounds));
     } else {
-        // Запуск backtracking
-        backtrack(solver, 0, 1);
+        search_stack_init(solver, 0, 1);
+    }
+
+    // Первое решение уже есть - first_only возвращает инкумбент
+    if (solver->config.first_only && solver->has_solution) {
+        solver->stack.active = false;
+        LOG_INFO("N=%u: используется начальное решение, max=%" PRIu64,
+                 solver->config.n, solver->best_max);
     }
+}
 
-    double elapsed = get_time_sec() - start_time;
+void backtrack_solver_begin_decision(BacktrackSolver *solver, value_t max_value) {
+    backtrack_solver_prepare(solver);
+    solver->run_time = 0.0;
+    solver->hot_allocations_start = subset_sum_manager_hot_allocations();
+
+    // Инкумбент не нужен: ищется множество с максимумом ровно max_value
+    solver->has_solution = false;
+    solver->best_solution.size = 0;
+    solver->best_max = max_value;
+    solver->stats.best_max = max_value;
+    solver->decision_max = max_value;
+    solver->stop_on_first = !solver->config.find_all_optimal;
+
+    // При N=1 корень - сразу последняя позиция
+    search_stack_init(solver, 0, solver->config.n == 1 ? max_value : 1);
+}
+
+bool backtrack_solver_run(BacktrackSolver *solver, uint64_t node_budget) {
+    double start_time = get_time_sec();
+    bool descending = solver->config.order == SEARCH_ORDER_DESCENDING &&
+                      solver->decision_max == 0;
+    bool finished = !solver->stack.active;
+
+    // Ограничения запуска дробят порцию: узлы - по остатку,
+    // время проверяется каждые BUDGET_TIME_SLICE узлов
+    while (!finished && node_budget > 0 && !solver->budget_exhausted) {
+        uint64_t slice = node_budget;
+        if (solver->config.node_limit > 0) {
+            uint64_t used = solver->stats.nodes_explored - solver->budget_nodes_start;
+            if (used >= solver->config.node_limit) {
+                solver->budget_exhausted = true;
+                break;
+            }
+            if (slice > solver->config.node_limit - used) {
+                slice = solver->config.node_limit - used;
+            }
+        }
+        if (solver->config.time_limit_sec > 0 && slice > BUDGET_TIME_SLICE) {
+            slice = BUDGET_TIME_SLICE;
+        }
+
+        uint64_t nodes_before = solver->stats.nodes_explored;
+        finished = descending ? search_stack_run_descending(solver, slice) :
+                                search_stack_run(solver, slice);
+        node_budget -= solver->stats.nodes_explored - nodes_before;
+
+        if (solver->config.stop_flag && *solver->config.stop_flag) {
+            break;
+        }
+        if (!finished && solver->config.time_limit_sec > 0 &&
+            get_time_sec() - solver->budget_start >= solver->config.time_limit_sec) {
+            solver->budget_exhausted = true;
+        }
+    }
+
+    solver->run_time += get_time_sec() - start_time;
+    return finished;
+}
+
+bool backtrack_solver_is_finished(const BacktrackSolver *solver) {
+    return !solver->stack.active;
+}
+
+bool backtrack_solver_budget_exhausted(const BacktrackSolver *solver) {
+    return solver->budget_exhausted;
+}
+
+void backtrack_solver_finish(BacktrackSolver *solver, SolutionResult *result) {
+#ifdef DEBUG
+    // Буферы менеджера рассчитаны при создании - узлы не должны выделять
+    // память; без расчета (presized = false) буферы растут, это только лог
+    uint64_t allocations = subset_sum_manager_hot_allocations() - solver->hot_allocations_start;
+    if (allocations > 0) {
+        LOG_WARNING("N=%u: %llu выделений памяти в горячем пути за %llu узлов",
+                    solver->config.n, (unsigned long long)allocations,
+                    (unsigned long long)solver->stats.nodes_explored);
+    }
+    assert(!solver->manager->presized || allocations == 0);
+#endif
+
+    // Незавершенный поиск не доказывает оптимальность найденного решения,
+    // как и остановка first_only на первом решении; менеджер, которому
+    // не хватило памяти, отклонял кандидатов без проверки
+    bool finished = !solver->stack.active && !solver->manager->out_of_memory;
+    bool stopped = solver->config.stop_flag && *solver->config.stop_flag;
 
     // Заполняем результат
     result->n = solver->config.n;
     if (solver->has_solution) {
         result->max_value = solver->best_max;
         number_set_copy(&result->solution_set, &solver->best_solution);
-        result->status = SOLUTION_STATUS_OPTIMAL;
     } else {
         result->max_value = 0;
         result->solution_set.size = 0;
-        if (solver->config.stop_flag && *solver->config.stop_flag) {
-            result->status = SOLUTION_STATUS_INTERRUPTED;
-        } else {
-            result->status = SOLUTION_STATUS_NO_SOLUTION;
-        }
     }
-    result->computation_time = elapsed;
+
+    if (!finished) {
+        result->status = stopped ? SOLUTION_STATUS_INTERRUPTED : SOLUTION_STATUS_TIMEOUT;
+    } else if (!solver->stack.complete && solver->has_solution) {
+        result->status = SOLUTION_STATUS_FEASIBLE;
+    } else if (solver->has_solution) {
+        result->status = SOLUTION_STATUS_OPTIMAL;
+    } else {
+        result->status = SOLUTION_STATUS_NO_SOLUTION;
+    }
+    result->computation_time = solver->run_time;
     result->nodes_explored = solver->stats.nodes_explored;
     result->timestamp = time(NULL);
 
-    log_complete(solver->config.n, result->status, elapsed, solver->stats.nodes_explored, solver->best_max);
+    log_complete(solver->config.n, result->status, solver->run_time,
+                 solver->stats.nodes_explored, solver->best_max);
+    search_bounds_log_stats(&solver->bounds);
+    if (solver->nogood_cache) {
+        LOG_INFO("Кеш тупиков N=%u: %llu отсечений, %llu записей", solver->config.n,
+                 (unsigned long long)solver->nogood_hits,
+                 (unsigned long long)solver->nogood_stores);
+    }
+}
+
+void backtrack_solver_save_checkpoint(const BacktrackSolver *solver,
+                                      SearchCheckpoint *checkpoint) {
+    const SearchStack *stack = &solver->stack;
+
+    checkpoint->n = solver->config.n;
+    checkpoint->find_all_optimal = solver->config.find_all_optimal;
+    subset_sum_manager_get_elements(solver->manager, &checkpoint->elements);
+
+    checkpoint->candidates.size = 0;
+    for (uint32_t d = 0; d <= stack->depth; d++) {
+        number_set_push(&checkpoint->candidates, stack->frames[d].next_candidate);
+    }
+    checkpoint->entering = stack->entering;
+
+    checkpoint->initial_bound = solver->config.initial_bound;
+    checkpoint->best_max = solver->has_solution ? solver->best_max : 0;
+    if (solver->has_solution) {
+        number_set_copy(&checkpoint->best_set, &solver->best_solution);
+    } else {
+        checkpoint->best_set.size = 0;
+    }
+
+    // Список оптимальных пересобирается целиком
+    for (size_t i = 0; i < checkpoint->optimal_count; i++) {
+        number_set_clear(&checkpoint->optimal_sets[i]);
+    }
+    free(checkpoint->optimal_sets);
+    checkpoint->optimal_sets = NULL;
+    checkpoint->optimal_count = solver->optimal_count;
+    if (solver->optimal_count > 0) {
+        checkpoint->optimal_sets = malloc(solver->optimal_count * sizeof(NumberSet));
+        for (size_t i = 0; i < solver->optimal_count; i++) {
+            number_set_init(&checkpoint->optimal_sets[i], solver->config.n);
+            number_set_copy(&checkpoint->optimal_sets[i], &solver->all_optimal_solutions[i]);
+        }
+    }
+
+    checkpoint->nodes_explored = solver->stats.nodes_explored;
+    checkpoint->computation_time = solver->run_time;
+    checkpoint->timestamp = time(NULL);
+}
+
+bool backtrack_solver_restore_checkpoint(BacktrackSolver *solver,
+                                         const SearchCheckpoint *checkpoint) {
+    uint32_t depth = (uint32_t)checkpoint->elements.size;
+    if (checkpoint->n != solver->config.n || depth > solver->config.n ||
+        checkpoint->candidates.size != depth + 1) {
+        return false;
+    }
+
+    // Граница точки, а не текущая из БД: иначе перебор до точки
+    // велся бы под другим ограничением кандидатов
+    solver->config.initial_bound = checkpoint->initial_bound;
+    backtrack_solver_prepare(solver);
+    solver->run_time = checkpoint->computation_time;
+    solver->hot_allocations_start = subset_sum_manager_hot_allocations();
+
+    // Менеджер восстанавливается повторным добавлением префикса
+    if (!backtrack_solver_load_prefix(solver, checkpoint->elements.elements, depth)) {
+        return false;
+    }
+
+    sync_bounds(solver, depth);
+
+    SearchStack *stack = &solver->stack;
+    for (uint32_t d = 0; d <= depth; d++) {
+        stack->frames[d].next_candidate = checkpoint->candidates.elements[d];
+        stack->frames[d].nogood_key = 0;
+    }
+    stack->base_depth = 0;
+    stack->depth = depth;
+    stack->entering = checkpoint->entering;
+    stack->active = true;
+    stack->complete = false;
+
+    if (checkpoint->best_max != 0) {
+        solver->best_max = checkpoint->best_max;
+        number_set_copy(&solver->best_solution, &checkpoint->best_set);
+        solver->has_solution = true;
+        solver->stats.best_max = checkpoint->best_max;
+    }
+
+    for (size_t i = 0; i < checkpoint->optimal_count; i++) {
+        number_set_copy(next_optimal_slot(solver), &checkpoint->optimal_sets[i]);
+    }
+    solver->stats.solutions_found = solver->optimal_count > 0 ?
+                                    (uint32_t)solver->optimal_count :
+                                    (solver->has_solution ? 1 : 0);
+    solver->stats.nodes_explored = checkpoint->nodes_explored;
+    solver->budget_nodes_start = checkpoint->nodes_explored;
+
+    log_start(solver->config.n, solver->config.initial_bound);
+    return true;
+}
+
+void backtrack_solver_solve(BacktrackSolver *solver, SolutionResult *result) {
+    backtrack_solver_begin(solver);
+    backtrack_solver_run(solver, UINT64_MAX);
+    backtrack_solver_finish(solver, result);
 }
 
 void backtrack_solver_solve_all(BacktrackSolver *solver, SolutionResult *result) {
     // Устанавливаем режим поиска всех оптимальных
     solver->config.find_all_optimal = true;
-    solver->optimal_count = 0;
 
     // Запускаем стандартный solve
     backtrack_solver_solve(solver, result);
 
     LOG_INFO("Найдено %zu оптимальных решений для N=%u",
-             solver->optimal_count, solver->config.n);
+             backtrack_solver_optimal_total(solver), solver->config.n);
 }
 
 size_t backtrack_solver_get_optimal_solutions(const BacktrackSolver *solver,
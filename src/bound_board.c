@@ -0,0 +1,117 @@
+/**
+ * bound_board.c - Общие границы для одновременно решаемых N
+ */
+
+#include <stdlib.h>
+#include "../include/bound_board.h"
+#include "../include/logger.h"
+
+// ============================================================================
+// Атомарные границы
+// ============================================================================
+
+/**
+ * Атомарный минимум (0 = границы нет)
+ */
+static void store_min(_Atomic value_t *bound, value_t value) {
+    value_t current = atomic_load_explicit(bound, memory_order_relaxed);
+    while ((current == 0 || value < current) &&
+           !atomic_compare_exchange_weak_explicit(bound, &current, value,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+}
+
+/**
+ * Атомарный максимум
+ */
+static void store_max(_Atomic value_t *bound, value_t value) {
+    value_t current = atomic_load_explicit(bound, memory_order_relaxed);
+    while (value > current &&
+           !atomic_compare_exchange_weak_explicit(bound, &current, value,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+}
+
+// ============================================================================
+// Создание и уничтожение
+// ============================================================================
+
+BoundBoard* bound_board_create(void) {
+    BoundBoard *board = malloc(sizeof(BoundBoard));
+    for (uint32_t n = 0; n <= BOUND_BOARD_MAX_N; n++) {
+        atomic_store(&board->slots[n].upper, 0);
+        atomic_store(&board->slots[n].lower, 0);
+        number_set_init(&board->slots[n].set, n > 0 ? n : 1);
+    }
+    pthread_mutex_init(&board->lock, NULL);
+    return board;
+}
+
+void bound_board_destroy(BoundBoard *board) {
+    if (!board) return;
+
+    for (uint32_t n = 0; n <= BOUND_BOARD_MAX_N; n++) {
+        number_set_clear(&board->slots[n].set);
+    }
+    pthread_mutex_destroy(&board->lock);
+    free(board);
+}
+
+// ============================================================================
+// Доступ
+// ============================================================================
+
+_Atomic value_t* bound_board_upper(BoundBoard *board, uint32_t n) {
+    return board && n >= 1 && n <= BOUND_BOARD_MAX_N ? &board->slots[n].upper : NULL;
+}
+
+const _Atomic value_t* bound_board_lower(BoundBoard *board, uint32_t n) {
+    return board && n >= 1 && n <= BOUND_BOARD_MAX_N ? &board->slots[n].lower : NULL;
+}
+
+void bound_board_publish(BoundBoard *board, const NumberSet *set) {
+    size_t size = set->size <= BOUND_BOARD_MAX_N ? set->size : BOUND_BOARD_MAX_N;
+
+    pthread_mutex_lock(&board->lock);
+    for (size_t k = size; k >= 1; k--) {
+        // Префикс из k наименьших элементов, его максимум - k-й элемент
+        BoundSlot *slot = &board->slots[k];
+        value_t max_value = set->elements[k - 1];
+        if (slot->set.size == k && number_set_max(&slot->set) <= max_value) {
+            continue;
+        }
+
+        slot->set.size = 0;
+        for (size_t i = 0; i < k; i++) {
+            number_set_push(&slot->set, set->elements[i]);
+        }
+        store_min(&slot->upper, max_value);
+        if (k < set->size) {
+            LOG_DEBUG("N=%zu: граница из множества N=%zu, max=%" PRIu64,
+                      k, set->size, max_value);
+        }
+    }
+    pthread_mutex_unlock(&board->lock);
+}
+
+void bound_board_set_optimal(BoundBoard *board, uint32_t n, value_t max_value) {
+    for (uint32_t m = n; m >= 1 && m <= BOUND_BOARD_MAX_N; m++) {
+        store_max(&board->slots[m].lower, max_value + (m - n));
+    }
+}
+
+bool bound_board_get(BoundBoard *board, uint32_t n, NumberSet *set) {
+    if (!board || n < 1 || n > BOUND_BOARD_MAX_N) {
+        return false;
+    }
+
+    pthread_mutex_lock(&board->lock);
+    bool found = board->slots[n].set.size == n;
+    if (found) {
+        number_set_copy(set, &board->slots[n].set);
+    }
+    pthread_mutex_unlock(&board->lock);
+    return found;
+}
@@ -0,0 +1,152 @@
+/**
+ * constructions.c - Явные конструкции множеств с различными суммами
+ */
+
+#include "../include/constructions.h"
+#include "../include/backtrack_solver.h"
+#include "../include/subset_sum_manager.h"
+#include "../include/logger.h"
+
+// ============================================================================
+// Конвей - Гай
+// ============================================================================
+
+bool conway_guy_set(uint32_t n, NumberSet *set) {
+    set->size = 0;
+    if (n == 0) {
+        return true;
+    }
+
+    value_t *u = malloc(((size_t)n + 1) * sizeof(value_t));
+    u[0] = 0;
+    u[1] = 1;
+
+    // r = round(sqrt(2m)) в целых: r^2 - r < 2m <= r^2 + r
+    uint64_t r = 0;
+    bool fits = true;
+    for (uint32_t m = 1; m < n && fits; m++) {
+        while (r * r + r < 2ULL * m) {
+            r++;
+        }
+        value_t doubled;
+        fits = !__builtin_mul_overflow(u[m], (value_t)2, &doubled);
+        u[m + 1] = doubled - u[m - r];
+    }
+
+    if (fits) {
+        for (uint32_t i = n; i >= 1; i--) {
+            number_set_push(set, u[n] - u[i - 1]);
+        }
+    }
+
+    free(u);
+    return fits;
+}
+
+// ============================================================================
+// Инкумбент
+// ============================================================================
+
+bool construct_incumbent(uint32_t n, NumberSet *set) {
+    if (n == 0 || n > CONWAY_GUY_VERIFIED_MAX_N || !conway_guy_set(n, set)) {
+        return false;
+    }
+
+    BSequenceCheck check = n <= B_SEQUENCE_IN_MEMORY_MAX ? check_b_sequence(set)
+                                                         : B_SEQUENCE_VALID;
+    if (check != B_SEQUENCE_VALID) {
+        if (check == B_SEQUENCE_INVALID) {
+            LOG_ERROR("Множество Конвея - Гая для N=%u не прошло проверку", n);
+        } else {
+            LOG_WARNING("Множество Конвея - Гая для N=%u не удалось проверить", n);
+        }
+        set->size = 0;
+        return false;
+    }
+
+    return true;
+}
+
+// ============================================================================
+// Продолжение (n-1)-множеств
+// ============================================================================
+
+/**
+ * Добавление элементов по порядку, false - коллизия
+ */
+static bool add_all(SubsetSumManager *manager, const value_t *elements, size_t count,
+                    value_t shift) {
+    for (size_t i = 0; i < count; i++) {
+        if (!subset_sum_manager_add_element(manager, elements[i] + shift)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool extend_smaller_sets(uint32_t n, const NumberSet *sources, size_t count,
+                         value_t bound, NumberSet *set) {
+    if (n < 2 || n > B_SEQUENCE_IN_MEMORY_MAX) {
+        return false;
+    }
+
+    SubsetSumManager *manager = subset_sum_manager_create_bounded(MANAGER_TYPE_DSET, n, bound);
+    value_t best = bound;
+    bool found = false;
+
+    for (size_t s = 0; s < count; s++) {
+        const NumberSet *source = &sources[s];
+        if (source->size != n - 1) {
+            continue;
+        }
+        value_t source_max = number_set_max(source);
+
+        // Расширение: наименьшее v вне T(A), при v < max(A) максимум не растет
+        subset_sum_manager_reset(manager);
+        if (!add_all(manager, source->elements, source->size, 0)) {
+            LOG_WARNING("N=%u: сохраненное множество N=%u не имеет различных сумм",
+                        n, n - 1);
+            continue;
+        }
+        value_t v = subset_sum_manager_next_candidate(manager, 1, best != 0 ? best : VALUE_MAX);
+        value_t extended_max = v > source_max ? v : source_max;
+        if (best == 0 || extended_max < best) {
+            set->size = 0;
+            bool placed = false;
+            for (size_t i = 0; i < source->size; i++) {
+                if (!placed && v < source->elements[i]) {
+                    number_set_push(set, v);
+                    placed = true;
+                }
+                number_set_push(set, source->elements[i]);
+            }
+            if (!placed) {
+                number_set_push(set, v);
+            }
+            best = extended_max;
+            found = true;
+        }
+
+        // Сдвиг с добавлением: {d} ∪ (A + d), максимум max(A) + d
+        value_t max_shift = n <= EXTEND_SHIFT_MAX_N ? EXTEND_MAX_SHIFTS : 0;
+        for (value_t d = 1; d <= max_shift && source_max + d < best; d++) {
+            subset_sum_manager_reset(manager);
+            if (!subset_sum_manager_add_element(manager, d) ||
+                !add_all(manager, source->elements, source->size, d)) {
+                continue;
+            }
+
+            set->size = 0;
+            number_set_push(set, d);
+            for (size_t i = 0; i < source->size; i++) {
+                number_set_push(set, source->elements[i] + d);
+            }
+            best = source_max + d;
+            found = true;
+            break;
+        }
+    }
+
+    subset_sum_manager_destroy(manager);
+    return found;
+}
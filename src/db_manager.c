@@ -42,7 +42,51 @@ static const char *SQL_CREATE_TABLES =
     "    UNIQUE(n, solution_set)"
     ");"
     ""
-    "CREATE INDEX IF NOT EXISTS idx_optimal_n ON optimal_sets(n);";
+    "CREATE INDEX IF NOT EXISTS idx_optimal_n ON optimal_sets(n);"
+    ""
+    "CREATE TABLE IF NOT EXISTS optimal_sets_pending ("
+    "    id INTEGER PRIMARY KEY AUTOINCREMENT,"
+    "    n INTEGER NOT NULL,"
+    "    max_value INTEGER NOT NULL,"
+    "    solution_set TEXT NOT NULL,"
+    "    UNIQUE(n, solution_set)"
+    ");"
+    ""
+    "CREATE TABLE IF NOT EXISTS checkpoints ("
+    "    n INTEGER PRIMARY KEY,"
+    "    find_all INTEGER NOT NULL,"
+    "    elements TEXT NOT NULL,"
+    "    candidates TEXT NOT NULL,"
+    "    entering INTEGER NOT NULL,"
+    "    initial_bound INTEGER NOT NULL,"
+    "    best_max INTEGER NOT NULL,"
+    "    best_set TEXT NOT NULL,"
+    "    optimal_sets TEXT NOT NULL,"
+    "    nodes_explored INTEGER NOT NULL,"
+    "    computation_time REAL NOT NULL,"
+    "    timestamp INTEGER NOT NULL"
+    ");";
+
+// Множества, записанные до завершения перебора прежними версиями: без
+// OPTIMAL в results или с максимумом больше доказанного
+static const char *SQL_CLEANUP_OPTIMAL =
+    "DELETE FROM optimal_sets WHERE max_value > COALESCE("
+    "    (SELECT MIN(r.max_value) FROM results r "
+    "     WHERE r.n = optimal_sets.n AND r.status = 'OPTIMAL'), -1);";
+
+// Незавершенные строки (TIMEOUT, FEASIBLE, INTERRUPTED): не больше одной
+// на N с лучшей границей и ни одной после OPTIMAL
+static const char *SQL_CLEANUP_UNFINISHED =
+    "DELETE FROM results WHERE status != 'OPTIMAL' AND EXISTS ("
+    "    SELECT 1 FROM results r WHERE r.n = results.n AND r.id != results.id AND ("
+    "        r.status = 'OPTIMAL' OR r.max_value < results.max_value OR"
+    "        (r.max_value = results.max_value AND r.id > results.id)));";
+
+static const char *SQL_SELECT_UNFINISHED_MAX =
+    "SELECT MIN(max_value) FROM results WHERE n = ? AND status != 'OPTIMAL';";
+
+static const char *SQL_DELETE_UNFINISHED =
+    "DELETE FROM results WHERE n = ? AND status != 'OPTIMAL';";
 
 static const char *SQL_INSERT_RESULT =
     "INSERT OR REPLACE INTO results "
@@ -53,11 +97,54 @@ static const char *SQL_INSERT_OPTIMAL =
     "INSERT OR IGNORE INTO optimal_sets (n, max_value, solution_set) "
     "VALUES (?, ?, ?);";
 
+static const char *SQL_DELETE_OPTIMAL_ABOVE =
+    "DELETE FROM optimal_sets WHERE n = ? AND max_value > ?;";
+
+static const char *SQL_INSERT_PENDING =
+    "INSERT OR IGNORE INTO optimal_sets_pending (n, max_value, solution_set) "
+    "VALUES (?, ?, ?);";
+
+static const char *SQL_DELETE_PENDING_ABOVE =
+    "DELETE FROM optimal_sets_pending WHERE n = ? AND max_value > ?;";
+
+static const char *SQL_SELECT_PENDING_MAX =
+    "SELECT MIN(max_value) FROM optimal_sets_pending WHERE n = ?;";
+
+static const char *SQL_PROMOTE_PENDING =
+    "INSERT OR IGNORE INTO optimal_sets (n, max_value, solution_set) "
+    "SELECT n, max_value, solution_set FROM optimal_sets_pending "
+    "WHERE n = ? AND max_value = ?;";
+
+static const char *SQL_DELETE_PENDING =
+    "DELETE FROM optimal_sets_pending WHERE n = ?;";
+
+static const char *SQL_HAS_CHECKPOINT =
+    "SELECT 1 FROM checkpoints WHERE n = ?;";
+
+static const char *SQL_INSERT_CHECKPOINT =
+    "INSERT OR REPLACE INTO checkpoints "
+    "(n, find_all, elements, candidates, entering, initial_bound, best_max, best_set, "
+    "optimal_sets, nodes_explored, computation_time, timestamp) "
+    "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);";
+
+static const char *SQL_SELECT_CHECKPOINT =
+    "SELECT find_all, elements, candidates, entering, initial_bound, best_max, best_set, "
+    "optimal_sets, nodes_explored, computation_time, timestamp "
+    "FROM checkpoints WHERE n = ?;";
+
+static const char *SQL_DELETE_CHECKPOINT =
+    "DELETE FROM checkpoints WHERE n = ?;";
+
 static const char *SQL_SELECT_RESULT =
     "SELECT max_value, solution_set, computation_time, status, nodes_explored, timestamp "
     "FROM results WHERE n = ? AND status = 'OPTIMAL' "
     "ORDER BY max_value ASC LIMIT 1;";
 
+static const char *SQL_SELECT_BEST_KNOWN =
+    "SELECT max_value, solution_set, computation_time, status, nodes_explored, timestamp "
+    "FROM results WHERE n = ? AND solution_set != '[]' "
+    "ORDER BY max_value ASC LIMIT 1;";
+
 static const char *SQL_SELECT_BEST_BOUND =
     "SELECT MIN(max_value) FROM results WHERE n = ?;";
 
@@ -151,6 +238,152 @@ static void deserialize_number_set(const char *str, NumberSet *set) {
     }
 }
 
+/**
+ * Сериализация массива множеств: множества через ';'
+ */
+static char* serialize_number_sets(const NumberSet *sets, size_t count) {
+    size_t buf_size = 1;
+    for (size_t i = 0; i < count; i++) {
+        buf_size += 4 + sets[i].size * 22;
+    }
+
+    char *result = malloc(buf_size);
+    char *ptr = result;
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) {
+            *ptr++ = ';';
+        }
+        char *set_str = serialize_number_set(&sets[i]);
+        size_t length = strlen(set_str);
+        memcpy(ptr, set_str, length);
+        ptr += length;
+        free(set_str);
+    }
+    *ptr = '\0';
+
+    return result;
+}
+
+/**
+ * Десериализация массива множеств, разделенных ';'
+ * Возвращает количество множеств, *sets - массив (нужно освободить)
+ */
+static size_t deserialize_number_sets(const char *str, NumberSet **sets) {
+    *sets = NULL;
+    if (!str || !*str) return 0;
+
+    size_t count = 1;
+    for (const char *ptr = str; *ptr; ptr++) {
+        if (*ptr == ';') count++;
+    }
+
+    *sets = malloc(count * sizeof(NumberSet));
+    const char *ptr = str;
+    for (size_t i = 0; i < count; i++) {
+        number_set_init(&(*sets)[i], 16);
+        deserialize_number_set(ptr, &(*sets)[i]);
+        const char *next = strchr(ptr, ';');
+        ptr = next ? next + 1 : ptr + strlen(ptr);
+    }
+
+    return count;
+}
+
+/**
+ * Выполнение запроса с параметрами (n[, value]), вызывается под mutex
+ */
+static bool exec_n_value(DatabaseManager *manager, const char *sql, uint32_t n, value_t value) {
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(manager->db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        return false;
+    }
+
+    sqlite3_bind_int(stmt, 1, (int)n);
+    if (sqlite3_bind_parameter_count(stmt) >= 2) {
+        sqlite3_bind_int64(stmt, 2, (sqlite3_int64)value);
+    }
+    bool success = (sqlite3_step(stmt) == SQLITE_DONE);
+
+    sqlite3_finalize(stmt);
+    return success;
+}
+
+/**
+ * Однозначный результат запроса с параметром n (NULL - нет значения),
+ * вызывается под mutex
+ */
+static bool query_value(DatabaseManager *manager, const char *sql, uint32_t n, value_t *value) {
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(manager->db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        return false;
+    }
+
+    sqlite3_bind_int(stmt, 1, (int)n);
+
+    bool found = false;
+    if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_type(stmt, 0) != SQLITE_NULL) {
+        *value = (value_t)sqlite3_column_int64(stmt, 0);
+        found = true;
+    }
+
+    sqlite3_finalize(stmt);
+    return found;
+}
+
+static bool select_value(DatabaseManager *manager, const char *sql, uint32_t n, value_t *value) {
+    if (!manager || !manager->initialized) return false;
+
+    pthread_mutex_lock(&manager->mutex);
+    bool found = query_value(manager, sql, n, value);
+    pthread_mutex_unlock(&manager->mutex);
+
+    return found;
+}
+
+/**
+ * Вставка множеств N запросом sql (n, max_value, solution_set) одной транзакцией
+ */
+static bool insert_sets(DatabaseManager *manager, const char *sql, uint32_t n,
+                        const NumberSet *sets, size_t count) {
+    if (!manager || !manager->initialized) return false;
+
+    pthread_mutex_lock(&manager->mutex);
+
+    sqlite3_exec(manager->db, "BEGIN TRANSACTION;", NULL, NULL, NULL);
+
+    sqlite3_stmt *stmt;
+    int rc = sqlite3_prepare_v2(manager->db, sql, -1, &stmt, NULL);
+    if (rc != SQLITE_OK) {
+        LOG_ERROR("Ошибка подготовки запроса: %s", sqlite3_errmsg(manager->db));
+        sqlite3_exec(manager->db, "ROLLBACK;", NULL, NULL, NULL);
+        pthread_mutex_unlock(&manager->mutex);
+        return false;
+    }
+
+    bool success = true;
+    for (size_t i = 0; i < count; i++) {
+        char *solution_str = serialize_number_set(&sets[i]);
+
+        sqlite3_reset(stmt);
+        sqlite3_bind_int(stmt, 1, (int)n);
+        sqlite3_bind_int64(stmt, 2, (sqlite3_int64)number_set_max(&sets[i]));
+        sqlite3_bind_text(stmt, 3, solution_str, -1, SQLITE_TRANSIENT);
+
+        rc = sqlite3_step(stmt);
+        if (rc != SQLITE_DONE && rc != SQLITE_CONSTRAINT) {
+            success = false;
+        }
+
+        free(solution_str);
+    }
+
+    sqlite3_finalize(stmt);
+    sqlite3_exec(manager->db, "COMMIT;", NULL, NULL, NULL);
+
+    pthread_mutex_unlock(&manager->mutex);
+    return success;
+}
+
 // ============================================================================
 // Функции инициализации
 // ============================================================================
@@ -182,6 +415,8 @@ DatabaseManager* db_manager_create(const char *db_path) {
         LOG_ERROR("Ошибка создания таблиц: %s", err_msg);
         sqlite3_free(err_msg);
     }
+    sqlite3_exec(manager->db, SQL_CLEANUP_UNFINISHED, NULL, NULL, NULL);
+    sqlite3_exec(manager->db, SQL_CLEANUP_OPTIMAL, NULL, NULL, NULL);
 
     manager->initialized = true;
     LOG_INFO("База данных инициализирована: %s", manager->db_path);
@@ -214,16 +449,14 @@ void db_manager_destroy(DatabaseManager *manager) {
 // Функции сохранения
 // ============================================================================
 
-bool db_manager_save_result(DatabaseManager *manager, const SolutionResult *result) {
-    if (!manager || !manager->initialized) return false;
-
-    pthread_mutex_lock(&manager->mutex);
-
+/**
+ * Вставка строки results, вызывается под mutex
+ */
+static bool insert_result(DatabaseManager *manager, const SolutionResult *result) {
     sqlite3_stmt *stmt;
     int rc = sqlite3_prepare_v2(manager->db, SQL_INSERT_RESULT, -1, &stmt, NULL);
     if (rc != SQLITE_OK) {
         LOG_ERROR("Ошибка подготовки запроса: %s", sqlite3_errmsg(manager->db));
-        pthread_mutex_unlock(&manager->mutex);
         return false;
     }
 
@@ -246,71 +479,168 @@ bool db_manager_save_result(DatabaseManager *manager, const SolutionResult *resu
 
     sqlite3_finalize(stmt);
     free(solution_str);
+    return success;
+}
+
+bool db_manager_save_result(DatabaseManager *manager, const SolutionResult *result) {
+    if (!manager || !manager->initialized) return false;
 
+    pthread_mutex_lock(&manager->mutex);
+    sqlite3_exec(manager->db, "BEGIN TRANSACTION;", NULL, NULL, NULL);
+
+    bool success = true;
+    value_t value;
+    if (result->status == SOLUTION_STATUS_OPTIMAL) {
+        // Доказанный оптимум заменяет незавершенную строку N, множества
+        // с большим максимумом не оптимальны
+        success = insert_result(manager, result) &&
+                  exec_n_value(manager, SQL_DELETE_UNFINISHED, result->n, 0) &&
+                  exec_n_value(manager, SQL_DELETE_OPTIMAL_ABOVE, result->n, result->max_value);
+    } else if (query_value(manager, SQL_HAS_OPTIMAL, result->n, &value)) {
+        // N уже решено - незавершенный результат не нужен
+    } else if (query_value(manager, SQL_SELECT_UNFINISHED_MAX, result->n, &value) &&
+               value < result->max_value) {
+        // Сохраненная незавершенная граница лучше
+    } else {
+        // Одна незавершенная строка на N: заменяется при равной или лучшей границе
+        success = exec_n_value(manager, SQL_DELETE_UNFINISHED, result->n, 0) &&
+                  insert_result(manager, result);
+    }
+
+    sqlite3_exec(manager->db, success ? "COMMIT;" : "ROLLBACK;", NULL, NULL, NULL);
     pthread_mutex_unlock(&manager->mutex);
     return success;
 }
 
 bool db_manager_save_optimal_sets(DatabaseManager *manager, uint32_t n,
                                   const NumberSet *sets, size_t count) {
+    return insert_sets(manager, SQL_INSERT_OPTIMAL, n, sets, count);
+}
+
+bool db_manager_delete_optimal_sets_above(DatabaseManager *manager, uint32_t n,
+                                         value_t max_value) {
+    if (!manager || !manager->initialized) return false;
+
+    pthread_mutex_lock(&manager->mutex);
+    bool success = exec_n_value(manager, SQL_DELETE_OPTIMAL_ABOVE, n, max_value);
+    pthread_mutex_unlock(&manager->mutex);
+
+    return success;
+}
+
+// ============================================================================
+// Предварительные оптимальные множества
+// ============================================================================
+
+bool db_manager_save_pending_sets(DatabaseManager *manager, uint32_t n,
+                                  const NumberSet *sets, size_t count) {
+    return insert_sets(manager, SQL_INSERT_PENDING, n, sets, count);
+}
+
+bool db_manager_delete_pending_sets_above(DatabaseManager *manager, uint32_t n,
+                                         value_t max_value) {
     if (!manager || !manager->initialized) return false;
 
     pthread_mutex_lock(&manager->mutex);
+    bool success = exec_n_value(manager, SQL_DELETE_PENDING_ABOVE, n, max_value);
+    pthread_mutex_unlock(&manager->mutex);
+
+    return success;
+}
+
+bool db_manager_get_pending_sets_max(DatabaseManager *manager, uint32_t n, value_t *max_value) {
+    return select_value(manager, SQL_SELECT_PENDING_MAX, n, max_value);
+}
+
+bool db_manager_promote_pending_sets(DatabaseManager *manager, uint32_t n,
+                                     value_t max_value) {
+    if (!manager || !manager->initialized) return false;
 
+    pthread_mutex_lock(&manager->mutex);
     sqlite3_exec(manager->db, "BEGIN TRANSACTION;", NULL, NULL, NULL);
+    bool success = exec_n_value(manager, SQL_PROMOTE_PENDING, n, max_value) &&
+                   exec_n_value(manager, SQL_DELETE_OPTIMAL_ABOVE, n, max_value) &&
+                   exec_n_value(manager, SQL_DELETE_PENDING, n, 0);
+    sqlite3_exec(manager->db, success ? "COMMIT;" : "ROLLBACK;", NULL, NULL, NULL);
+    pthread_mutex_unlock(&manager->mutex);
+
+    if (!success) {
+        LOG_ERROR("N=%u: не удалось перенести предварительные множества", n);
+    }
+    return success;
+}
+
+bool db_manager_discard_pending_sets(DatabaseManager *manager, uint32_t n) {
+    if (!manager || !manager->initialized) return false;
+
+    pthread_mutex_lock(&manager->mutex);
+    bool success = exec_n_value(manager, SQL_DELETE_PENDING, n, 0);
+    pthread_mutex_unlock(&manager->mutex);
+
+    return success;
+}
+
+// ============================================================================
+// Контрольные точки
+// ============================================================================
+
+bool db_manager_save_checkpoint(DatabaseManager *manager, const SearchCheckpoint *checkpoint) {
+    if (!manager || !manager->initialized) return false;
+
+    pthread_mutex_lock(&manager->mutex);
 
     sqlite3_stmt *stmt;
-    int rc = sqlite3_prepare_v2(manager->db, SQL_INSERT_OPTIMAL, -1, &stmt, NULL);
+    int rc = sqlite3_prepare_v2(manager->db, SQL_INSERT_CHECKPOINT, -1, &stmt, NULL);
     if (rc != SQLITE_OK) {
         LOG_ERROR("Ошибка подготовки запроса: %s", sqlite3_errmsg(manager->db));
-        sqlite3_exec(manager->db, "ROLLBACK;", NULL, NULL, NULL);
         pthread_mutex_unlock(&manager->mutex);
         return false;
     }
 
-    bool success = true;
-    for (size_t i = 0; i < count; i++) {
-        // Находим максимум
-        value_t max_val = 0;
-        for (size_t j = 0; j < sets[i].size; j++) {
-            if (sets[i].elements[j] > max_val) {
-                max_val = sets[i].elements[j];
-            }
-        }
+    char *elements_str = serialize_number_set(&checkpoint->elements);
+    char *candidates_str = serialize_number_set(&checkpoint->candidates);
+    char *best_str = serialize_number_set(&checkpoint->best_set);
+    char *optimal_str = serialize_number_sets(checkpoint->optimal_sets,
+                                              checkpoint->optimal_count);
+
+    sqlite3_bind_int(stmt, 1, (int)checkpoint->n);
+    sqlite3_bind_int(stmt, 2, checkpoint->find_all_optimal ? 1 : 0);
+    sqlite3_bind_text(stmt, 3, elements_str, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 4, candidates_str, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 5, checkpoint->entering ? 1 : 0);
+    sqlite3_bind_int64(stmt, 6, (sqlite3_int64)checkpoint->initial_bound);
+    sqlite3_bind_int64(stmt, 7, (sqlite3_int64)checkpoint->best_max);
+    sqlite3_bind_text(stmt, 8, best_str, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 9, optimal_str, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, 10, (sqlite3_int64)checkpoint->nodes_explored);
+    sqlite3_bind_double(stmt, 11, checkpoint->computation_time);
+    sqlite3_bind_int64(stmt, 12, checkpoint->timestamp);
 
-        char *solution_str = serialize_number_set(&sets[i]);
-
-        sqlite3_reset(stmt);
-        sqlite3_bind_int(stmt, 1, (int)n);
-        sqlite3_bind_int64(stmt, 2, (sqlite3_int64)max_val);
-        sqlite3_bind_text(stmt, 3, solution_str, -1, SQLITE_TRANSIENT);
-
-        rc = sqlite3_step(stmt);
-        if (rc != SQLITE_DONE && rc != SQLITE_CONSTRAINT) {
-            success = false;
-        }
+    rc = sqlite3_step(stmt);
+    bool success = (rc == SQLITE_DONE);
 
-        free(solution_str);
+    if (!success) {
+        LOG_ERROR("Ошибка сохранения контрольной точки: %s", sqlite3_errmsg(manager->db));
     }
 
     sqlite3_finalize(stmt);
-    sqlite3_exec(manager->db, "COMMIT;", NULL, NULL, NULL);
+    free(elements_str);
+    free(candidates_str);
+    free(best_str);
+    free(optimal_str);
 
     pthread_mutex_unlock(&manager->mutex);
     return success;
 }
 
-// ============================================================================
-// Функции загрузки
-// ============================================================================
-
-bool db_manager_get_result(DatabaseManager *manager, uint32_t n, SolutionResult *result) {
+bool db_manager_load_checkpoint(DatabaseManager *manager, uint32_t n,
+                                SearchCheckpoint *checkpoint) {
     if (!manager || !manager->initialized) return false;
 
     pthread_mutex_lock(&manager->mutex);
 
     sqlite3_stmt *stmt;
-    int rc = sqlite3_prepare_v2(manager->db, SQL_SELECT_RESULT, -1, &stmt, NULL);
+    int rc = sqlite3_prepare_v2(manager->db, SQL_SELECT_CHECKPOINT, -1, &stmt, NULL);
     if (rc != SQLITE_OK) {
         pthread_mutex_unlock(&manager->mutex);
         return false;
@@ -320,46 +650,93 @@ bool db_manager_get_result(DatabaseManager *manager, uint32_t n, SolutionResult
 
     bool found = false;
     if (sqlite3_step(stmt) == SQLITE_ROW) {
-        result->n = n;
-        result->max_value = (value_t)sqlite3_column_int64(stmt, 0);
+        checkpoint->n = n;
+        checkpoint->find_all_optimal = sqlite3_column_int(stmt, 0) != 0;
+        deserialize_number_set((const char *)sqlite3_column_text(stmt, 1),
+                               &checkpoint->elements);
+        deserialize_number_set((const char *)sqlite3_column_text(stmt, 2),
+                               &checkpoint->candidates);
+        checkpoint->entering = sqlite3_column_int(stmt, 3) != 0;
+        checkpoint->initial_bound = (value_t)sqlite3_column_int64(stmt, 4);
+        checkpoint->best_max = (value_t)sqlite3_column_int64(stmt, 5);
+        deserialize_number_set((const char *)sqlite3_column_text(stmt, 6),
+                               &checkpoint->best_set);
+        checkpoint->optimal_count = deserialize_number_sets(
+            (const char *)sqlite3_column_text(stmt, 7), &checkpoint->optimal_sets);
+        checkpoint->nodes_explored = (uint64_t)sqlite3_column_int64(stmt, 8);
+        checkpoint->computation_time = sqlite3_column_double(stmt, 9);
+        checkpoint->timestamp = (time_t)sqlite3_column_int64(stmt, 10);
+
+        // Кандидатов на один больше, чем элементов префикса
+        found = checkpoint->candidates.size == checkpoint->elements.size + 1;
+        if (!found) {
+            LOG_WARNING("Контрольная точка для N=%u повреждена, игнорируется", n);
+        }
+    }
 
-        const char *solution_str = (const char *)sqlite3_column_text(stmt, 1);
-        deserialize_number_set(solution_str, &result->solution_set);
+    sqlite3_finalize(stmt);
+    pthread_mutex_unlock(&manager->mutex);
 
-        result->computation_time = sqlite3_column_double(stmt, 2);
+    return found;
+}
 
-        const char *status_str = (const char *)sqlite3_column_text(stmt, 3);
-        if (strcmp(status_str, "OPTIMAL") == 0) {
-            result->status = SOLUTION_STATUS_OPTIMAL;
-        } else if (strcmp(status_str, "FEASIBLE") == 0) {
-            result->status = SOLUTION_STATUS_FEASIBLE;
-        } else if (strcmp(status_str, "TIMEOUT") == 0) {
-            result->status = SOLUTION_STATUS_TIMEOUT;
-        } else if (strcmp(status_str, "INTERRUPTED") == 0) {
-            result->status = SOLUTION_STATUS_INTERRUPTED;
-        } else {
-            result->status = SOLUTION_STATUS_NO_SOLUTION;
-        }
+bool db_manager_delete_checkpoint(DatabaseManager *manager, uint32_t n) {
+    if (!manager || !manager->initialized) return false;
 
-        result->nodes_explored = (uint64_t)sqlite3_column_int64(stmt, 4);
-        result->timestamp = (time_t)sqlite3_column_int64(stmt, 5);
+    pthread_mutex_lock(&manager->mutex);
 
-        found = true;
+    sqlite3_stmt *stmt;
+    int rc = sqlite3_prepare_v2(manager->db, SQL_DELETE_CHECKPOINT, -1, &stmt, NULL);
+    if (rc != SQLITE_OK) {
+        pthread_mutex_unlock(&manager->mutex);
+        return false;
+    }
+
+    sqlite3_bind_int(stmt, 1, (int)n);
+    bool success = (sqlite3_step(stmt) == SQLITE_DONE);
+
+    sqlite3_finalize(stmt);
+    pthread_mutex_unlock(&manager->mutex);
+
+    return success;
+}
+
+bool db_manager_has_checkpoint(DatabaseManager *manager, uint32_t n) {
+    if (!manager || !manager->initialized) return false;
+
+    pthread_mutex_lock(&manager->mutex);
+
+    sqlite3_stmt *stmt;
+    int rc = sqlite3_prepare_v2(manager->db, SQL_HAS_CHECKPOINT, -1, &stmt, NULL);
+    if (rc != SQLITE_OK) {
+        pthread_mutex_unlock(&manager->mutex);
+        return false;
     }
 
+    sqlite3_bind_int(stmt, 1, (int)n);
+    bool found = (sqlite3_step(stmt) == SQLITE_ROW);
+
     sqlite3_finalize(stmt);
     pthread_mutex_unlock(&manager->mutex);
 
     return found;
 }
 
-bool db_manager_get_best_bound(DatabaseManager *manager, uint32_t n, value_t *bound) {
+// ============================================================================
+// Функции загрузки
+// ============================================================================
+
+/**
+ * Чтение одной строки results для N запросом sql
+ */
+static bool select_result(DatabaseManager *manager, const char *sql, uint32_t n,
+                          SolutionResult *result) {
     if (!manager || !manager->initialized) return false;
 
     pthread_mutex_lock(&manager->mutex);
 
     sqlite3_stmt *stmt;
-    int rc = sqlite3_prepare_v2(manager->db, SQL_SELECT_BEST_BOUND, -1, &stmt, NULL);
+    int rc = sqlite3_prepare_v2(manager->db, sql, -1, &stmt, NULL);
     if (rc != SQLITE_OK) {
         pthread_mutex_unlock(&manager->mutex);
         return false;
@@ -368,8 +745,21 @@ bool db_manager_get_best_bound(DatabaseManager *manager, uint32_t n, value_t *bo
     sqlite3_bind_int(stmt, 1, (int)n);
 
     bool found = false;
-    if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_type(stmt, 0) != SQLITE_NULL) {
-        *bound = (value_t)sqlite3_column_int64(stmt, 0);
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        result->n = n;
+        result->max_value = (value_t)sqlite3_column_int64(stmt, 0);
+
+        const char *solution_str = (const char *)sqlite3_column_text(stmt, 1);
+        deserialize_number_set(solution_str, &result->solution_set);
+
+        result->computation_time = sqlite3_column_double(stmt, 2);
+
+        const char *status_str = (const char *)sqlite3_column_text(stmt, 3);
+        result->status = solution_status_from_string(status_str);
+
+        result->nodes_explored = (uint64_t)sqlite3_column_int64(stmt, 4);
+        result->timestamp = (time_t)sqlite3_column_int64(stmt, 5);
+
         found = true;
     }
 
@@ -379,6 +769,18 @@ bool db_manager_get_best_bound(DatabaseManager *manager, uint32_t n, value_t *bo
     return found;
 }
 
+bool db_manager_get_result(DatabaseManager *manager, uint32_t n, SolutionResult *result) {
+    return select_result(manager, SQL_SELECT_RESULT, n, result);
+}
+
+bool db_manager_get_best_known(DatabaseManager *manager, uint32_t n, SolutionResult *result) {
+    return select_result(manager, SQL_SELECT_BEST_KNOWN, n, result);
+}
+
+bool db_manager_get_best_bound(DatabaseManager *manager, uint32_t n, value_t *bound) {
+    return select_value(manager, SQL_SELECT_BEST_BOUND, n, bound);
+}
+
 bool db_manager_has_optimal_solution(DatabaseManager *manager, uint32_t n) {
     if (!manager || !manager->initialized) return false;
 
@@ -525,13 +927,7 @@ size_t db_manager_get_all_results(DatabaseManager *manager, SolutionResult **res
         r->computation_time = sqlite3_column_double(stmt, 3);
 
         const char *status_str = (const char *)sqlite3_column_text(stmt, 4);
-        if (strcmp(status_str, "OPTIMAL") == 0) {
-            r->status = SOLUTION_STATUS_OPTIMAL;
-        } else if (strcmp(status_str, "FEASIBLE") == 0) {
-            r->status = SOLUTION_STATUS_FEASIBLE;
-        } else {
-            r->status = SOLUTION_STATUS_NO_SOLUTION;
-        }
+        r->status = solution_status_from_string(status_str);
 
         r->nodes_explored = (uint64_t)sqlite3_column_int64(stmt, 5);
         r->timestamp = sqlite3_column_int64(stmt, 6);
@@ -0,0 +1,372 @@
+/**
+ * decision_solver.c - Поиск через задачи распознавания по максимуму
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../include/decision_solver.h"
+#include "../include/logger.h"
+
+// ============================================================================
+// Константы
+// ============================================================================
+
+#define COORDINATOR_POLL_USEC 100000
+
+// ============================================================================
+// Воркер
+// ============================================================================
+
+/**
+ * Прогресс решателя воркера публикуется для общего отчета
+ */
+static void worker_progress(const SearchStats *stats, void *user_data) {
+    DecisionWorker *worker = (DecisionWorker *)user_data;
+    atomic_store_explicit(&worker->nodes, stats->nodes_explored, memory_order_relaxed);
+}
+
+/**
+ * Следующее непроверенное M (0 - проверять больше нечего)
+ * Новое M ставится воркеру под lock, поэтому отмена его не пропустит.
+ */
+static value_t take_max_value(DecisionSolver *decision, DecisionWorker *worker) {
+    value_t max_value = 0;
+
+    pthread_mutex_lock(&decision->lock);
+    if (decision->next_max <= decision->last_max &&
+        (decision->feasible_max == 0 || decision->next_max < decision->feasible_max)) {
+        max_value = decision->next_max++;
+    }
+    worker->max_value = max_value;
+    worker->cancel = false;
+    pthread_mutex_unlock(&decision->lock);
+
+    return max_value;
+}
+
+/**
+ * Решение для M: если M меньше найденных раньше, оно новое лучшее,
+ * проверки больших M отменяются
+ */
+static void record_feasible(DecisionSolver *decision, const BacktrackSolver *solver,
+                            value_t max_value) {
+    if (decision->feasible_max != 0 && max_value >= decision->feasible_max) {
+        return;
+    }
+
+    decision->feasible_max = max_value;
+    number_set_copy(&decision->best_solution, &solver->best_solution);
+
+    if (decision->config.find_all_optimal) {
+        for (size_t i = 0; i < decision->optimal_count; i++) {
+            number_set_clear(&decision->all_optimal_solutions[i]);
+        }
+        free(decision->all_optimal_solutions);
+
+        decision->optimal_count = solver->optimal_count;
+        decision->optimal_streamed = solver->optimal_streamed;
+        decision->all_optimal_solutions = malloc(solver->optimal_count * sizeof(NumberSet));
+        for (size_t i = 0; i < solver->optimal_count; i++) {
+            number_set_init(&decision->all_optimal_solutions[i], decision->config.n);
+            number_set_copy(&decision->all_optimal_solutions[i],
+                            &solver->all_optimal_solutions[i]);
+        }
+    }
+
+    for (uint32_t i = 0; i < decision->thread_count; i++) {
+        if (decision->workers[i].max_value > max_value) {
+            decision->workers[i].cancel = true;
+        }
+    }
+}
+
+static void* worker_main(void *arg) {
+    DecisionWorker *worker = (DecisionWorker *)arg;
+    DecisionSolver *decision = worker->owner;
+    BacktrackSolver *solver = worker->solver;
+    uint32_t n = decision->config.n;
+
+    value_t max_value;
+    while ((max_value = take_max_value(decision, worker)) != 0) {
+        backtrack_solver_begin_decision(solver, max_value);
+        backtrack_solver_run(solver, UINT64_MAX);
+
+        uint64_t nodes = solver->stats.nodes_explored;
+        atomic_fetch_add_explicit(&worker->done_nodes, nodes, memory_order_relaxed);
+        atomic_store_explicit(&worker->nodes, 0, memory_order_relaxed);
+
+        // Отмененная проверка ничего не доказывает
+        bool finished = backtrack_solver_is_finished(solver);
+
+        pthread_mutex_lock(&decision->lock);
+        worker->max_value = 0;
+        search_bounds_merge_stats(&decision->bounds, &solver->bounds);
+        if (solver->has_solution) {
+            // Решение отмененной проверки допустимо, но не доказывает
+            // оптимальность - итог при отмене не OPTIMAL
+            if (finished) {
+                LOG_INFO("N=%u, max=%" PRIu64 ": решение есть, узлов=%llu",
+                         n, max_value, (unsigned long long)nodes);
+            }
+            record_feasible(decision, solver, max_value);
+        } else if (finished) {
+            LOG_INFO("N=%u, max=%" PRIu64 ": решений нет, узлов=%llu",
+                     n, max_value, (unsigned long long)nodes);
+        }
+        pthread_mutex_unlock(&decision->lock);
+    }
+
+    atomic_fetch_sub_explicit(&decision->running, 1, memory_order_release);
+    return NULL;
+}
+
+// ============================================================================
+// Создание и уничтожение
+// ============================================================================
+
+DecisionSolver* decision_solver_create(const SolverConfig *config, uint32_t thread_count) {
+    DecisionSolver *decision = malloc(sizeof(DecisionSolver));
+    decision->config = *config;
+    if (decision->config.initial_bound == 0) {
+        decision->config.initial_bound = compute_initial_bound(config->n);
+    }
+
+    if (thread_count == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = cpus > 0 ? (uint32_t)cpus : 1;
+    }
+    decision->thread_count = thread_count;
+
+    number_set_init(&decision->incumbent, config->n);
+    number_set_init(&decision->best_solution, config->n);
+    decision->lower_bound = 0;
+    pthread_mutex_init(&decision->lock, NULL);
+    search_bounds_init(&decision->bounds, config->n,
+                       BOUND_RULES_ALL & ~config->disabled_bounds);
+
+    // Решатели воркеров останавливаются своими флагами отмены, прогресс
+    // публикуют через callback - отчет печатает координатор
+    decision->workers = calloc(thread_count, sizeof(DecisionWorker));
+    for (uint32_t i = 0; i < thread_count; i++) {
+        DecisionWorker *worker = &decision->workers[i];
+        SolverConfig worker_config = decision->config;
+        worker_config.stop_flag = &worker->cancel;
+        worker_config.log_interval_sec = 1;
+        worker_config.nogood_cache_mb = 0;  // Поддеревья зависят от M
+        worker_config.time_limit_sec = 0;   // Ограничения запуска - общие, у координатора
+        worker_config.node_limit = 0;
+
+        worker->owner = decision;
+        worker->solver = backtrack_solver_create(&worker_config);
+        backtrack_solver_set_progress_callback(worker->solver, worker_progress, worker);
+    }
+
+    decision->all_optimal_solutions = NULL;
+    decision->optimal_count = 0;
+    decision->optimal_streamed = 0;
+
+    return decision;
+}
+
+void decision_solver_destroy(DecisionSolver *decision) {
+    if (!decision) return;
+
+    for (uint32_t i = 0; i < decision->thread_count; i++) {
+        backtrack_solver_destroy(decision->workers[i].solver);
+    }
+    free(decision->workers);
+
+    if (decision->all_optimal_solutions) {
+        for (size_t i = 0; i < decision->optimal_count; i++) {
+            number_set_clear(&decision->all_optimal_solutions[i]);
+        }
+        free(decision->all_optimal_solutions);
+    }
+
+    number_set_clear(&decision->incumbent);
+    number_set_clear(&decision->best_solution);
+    search_bounds_destroy(&decision->bounds);
+    pthread_mutex_destroy(&decision->lock);
+    free(decision);
+}
+
+void decision_solver_set_incumbent(DecisionSolver *decision, const NumberSet *set) {
+    number_set_copy(&decision->incumbent, set);
+}
+
+void decision_solver_set_lower_bound(DecisionSolver *decision, value_t lower_bound) {
+    decision->lower_bound = lower_bound;
+}
+
+void decision_solver_set_optimal_callback(DecisionSolver *decision,
+                                          OptimalSetCallback callback,
+                                          void *user_data) {
+    for (uint32_t i = 0; i < decision->thread_count; i++) {
+        backtrack_solver_set_optimal_callback(decision->workers[i].solver, callback, user_data);
+    }
+}
+
+// ============================================================================
+// Решение
+// ============================================================================
+
+static uint64_t total_nodes(const DecisionSolver *decision) {
+    uint64_t nodes = 0;
+    for (uint32_t i = 0; i < decision->thread_count; i++) {
+        nodes += atomic_load_explicit(&decision->workers[i].done_nodes, memory_order_relaxed);
+        nodes += atomic_load_explicit(&decision->workers[i].nodes, memory_order_relaxed);
+    }
+    return nodes;
+}
+
+/**
+ * Отмена всех проверок и раздачи новых M
+ */
+static void cancel_all(DecisionSolver *decision) {
+    pthread_mutex_lock(&decision->lock);
+    decision->next_max = decision->last_max + 1;
+    for (uint32_t i = 0; i < decision->thread_count; i++) {
+        decision->workers[i].cancel = true;
+    }
+    pthread_mutex_unlock(&decision->lock);
+}
+
+/**
+ * Наименьшее M, которое сейчас проверяется (0 - нет)
+ */
+static value_t lowest_running_max(DecisionSolver *decision) {
+    value_t lowest = 0;
+    pthread_mutex_lock(&decision->lock);
+    for (uint32_t i = 0; i < decision->thread_count; i++) {
+        value_t max_value = decision->workers[i].max_value;
+        if (max_value != 0 && (lowest == 0 || max_value < lowest)) {
+            lowest = max_value;
+        }
+    }
+    pthread_mutex_unlock(&decision->lock);
+    return lowest;
+}
+
+void decision_solver_solve(DecisionSolver *decision, SolutionResult *result) {
+    uint32_t n = decision->config.n;
+    bool has_incumbent = decision->incumbent.size > 0;
+    value_t incumbent_max = has_incumbent ? number_set_max(&decision->incumbent) : 0;
+
+    // Доказанная нижняя граница: правила отсечения и внешняя граница
+    value_t lower = search_bounds_lower_bound(&decision->workers[0].solver->bounds);
+    if (decision->lower_bound > lower) {
+        lower = decision->lower_bound;
+    }
+
+    // Проверяются M ниже инкумбента (все оптимальные - включая его максимум)
+    value_t upper = has_incumbent ? incumbent_max : decision->config.initial_bound - 1;
+    if (has_incumbent && !decision->config.find_all_optimal) {
+        upper--;
+    }
+
+    decision->next_max = lower;
+    decision->last_max = upper;
+    decision->feasible_max = 0;
+    decision->best_solution.size = 0;
+    search_bounds_reset_stats(&decision->bounds);
+    atomic_store(&decision->running, decision->thread_count);
+    for (uint32_t i = 0; i < decision->thread_count; i++) {
+        decision->workers[i].max_value = 0;
+        atomic_store(&decision->workers[i].nodes, 0);
+        atomic_store(&decision->workers[i].done_nodes, 0);
+    }
+
+    log_start(n, decision->config.initial_bound);
+
+    if (decision->config.first_only && has_incumbent) {
+        // Первое решение уже есть - перебор не нужен
+        decision->last_max = 0;
+        LOG_INFO("N=%u: используется начальное решение, max=%" PRIu64, n, incumbent_max);
+    } else {
+        LOG_INFO("N=%u: распознавание max=%" PRIu64 "..%" PRIu64 ", потоков=%u",
+                 n, lower, upper, decision->thread_count);
+    }
+
+    double start_time = get_time_sec();
+    time_t last_log = time(NULL);
+
+    for (uint32_t i = 0; i < decision->thread_count; i++) {
+        pthread_create(&decision->workers[i].thread, NULL, worker_main, &decision->workers[i]);
+    }
+
+    // Координатор: передает внешнюю остановку, следит за ограничениями
+    // запуска и печатает общий прогресс
+    bool interrupted = false;
+    bool budget_stop = false;
+    while (atomic_load_explicit(&decision->running, memory_order_acquire) > 0) {
+        usleep(COORDINATOR_POLL_USEC);
+
+        if (!interrupted && decision->config.stop_flag && *decision->config.stop_flag) {
+            interrupted = true;
+            cancel_all(decision);
+        }
+        if (!interrupted && !budget_stop &&
+            solver_config_budget_exhausted(&decision->config, get_time_sec() - start_time,
+                                           total_nodes(decision))) {
+            budget_stop = true;
+            cancel_all(decision);
+        }
+
+        time_t now = time(NULL);
+        if (now - last_log >= decision->config.log_interval_sec) {
+            last_log = now;
+            LOG_INFO("N=%u: nodes=%llu, time=%.1fs, max=%" PRIu64,
+                     n, (unsigned long long)total_nodes(decision),
+                     get_time_sec() - start_time, lowest_running_max(decision));
+        }
+    }
+
+    for (uint32_t i = 0; i < decision->thread_count; i++) {
+        pthread_join(decision->workers[i].thread, NULL);
+    }
+
+    double elapsed = get_time_sec() - start_time;
+
+    // Наименьшее M с решением оптимально (меньшие M доказаны пустыми);
+    // если пусты все M ниже инкумбента - оптимален инкумбент
+    const NumberSet *best = NULL;
+    if (decision->feasible_max != 0) {
+        best = &decision->best_solution;
+    } else if (has_incumbent) {
+        best = &decision->incumbent;
+    }
+
+    result->n = n;
+    if (best) {
+        result->max_value = number_set_max(best);
+        number_set_copy(&result->solution_set, best);
+        result->status = interrupted ? SOLUTION_STATUS_INTERRUPTED :
+                         budget_stop ? SOLUTION_STATUS_TIMEOUT :
+                         decision->config.first_only && decision->feasible_max == 0 ?
+                         SOLUTION_STATUS_FEASIBLE : SOLUTION_STATUS_OPTIMAL;
+    } else {
+        result->max_value = 0;
+        result->solution_set.size = 0;
+        result->status = interrupted ? SOLUTION_STATUS_INTERRUPTED :
+                         budget_stop ? SOLUTION_STATUS_TIMEOUT : SOLUTION_STATUS_NO_SOLUTION;
+    }
+    result->computation_time = elapsed;
+    result->nodes_explored = total_nodes(decision);
+    result->timestamp = time(NULL);
+
+    log_complete(n, result->status, elapsed, result->nodes_explored, result->max_value);
+    search_bounds_log_stats(&decision->bounds);
+
+    if (decision->config.find_all_optimal) {
+        LOG_INFO("Найдено %zu оптимальных решений для N=%u",
+                 decision->optimal_count + decision->optimal_streamed, n);
+    }
+}
+
+size_t decision_solver_get_optimal_solutions(const DecisionSolver *decision,
+                                             NumberSet **solutions) {
+    *solutions = decision->all_optimal_solutions;
+    return decision->optimal_count;
+}
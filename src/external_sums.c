@@ -0,0 +1,266 @@
+/**
+ * external_sums.c - Внешняя проверка различности сумм подмножеств
+ *
+ * Прогоны не записываются на диск целиком: прогон c - это отсортированная
+ * таблица сумм младшей части, сдвинутая на сумму base_c c-го подмножества
+ * старшей части. На диске (через mmap) лежит только общая таблица, поэтому
+ * для N = 36 и r = 24 нужно 256 МБ файла вместо 512 ГБ всех сумм.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include "../include/external_sums.h"
+#include "../include/logger.h"
+
+// ============================================================================
+// Структуры слияния
+// ============================================================================
+
+/**
+ * Курсор прогона в куче слияния
+ */
+typedef struct {
+    value_t value;          // Текущее значение прогона
+    uint64_t position;      // Позиция в таблице младших сумм
+    uint64_t run;           // Номер прогона (индекс в массиве сдвигов)
+} MergeCursor;
+
+// ============================================================================
+// Временная таблица в памяти, отображенной на файл
+// ============================================================================
+
+/**
+ * Создание временного файла на count значений и отображение его в память
+ * Файл удаляется сразу после открытия, место освобождается при munmap.
+ */
+static value_t* map_temp_table(const char *temp_dir, size_t count) {
+    if (!temp_dir) {
+        temp_dir = getenv("TMPDIR");
+    }
+    if (!temp_dir || !*temp_dir) {
+        temp_dir = "/tmp";
+    }
+
+    size_t path_size = strlen(temp_dir) + 32;
+    char *path = malloc(path_size);
+    snprintf(path, path_size, "%s/erdos_sums_XXXXXX", temp_dir);
+
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        LOG_ERROR("Не удалось создать временный файл в %s", temp_dir);
+        free(path);
+        return NULL;
+    }
+    unlink(path);
+    free(path);
+
+    size_t bytes = count * sizeof(value_t);
+    if (ftruncate(fd, (off_t)bytes) != 0) {
+        LOG_ERROR("Не удалось выделить %zu байт во временном файле", bytes);
+        close(fd);
+        return NULL;
+    }
+
+    void *table = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (table == MAP_FAILED) {
+        LOG_ERROR("Не удалось отобразить временный файл (%zu байт)", bytes);
+        return NULL;
+    }
+
+    return table;
+}
+
+/**
+ * Построение отсортированных сумм младшей части удвоением:
+ * суммы k+1 элементов - слияние sums_k и sums_k + a_k.
+ * Буферы buffers[0] и buffers[1] чередуются, результат возвращается в *sorted.
+ * Возвращает false, если суммы младшей части уже совпадают.
+ */
+static bool build_low_table(value_t *buffers[2], const value_t *elements, size_t count,
+                            value_t **sorted) {
+    value_t *src = buffers[0];
+    value_t *dst = buffers[1];
+    size_t size = 1;
+    src[0] = 0;
+
+    for (size_t e = 0; e < count; e++) {
+        value_t value = elements[e];
+        size_t i = 0;
+        size_t j = 0;
+        size_t out = 0;
+
+        while (i < size && j < size) {
+            value_t a = src[i];
+            value_t b = src[j] + value;
+            if (a < b) {
+                dst[out++] = a;
+                i++;
+            } else if (a > b) {
+                dst[out++] = b;
+                j++;
+            } else {
+                return false;
+            }
+        }
+        while (i < size) dst[out++] = src[i++];
+        while (j < size) dst[out++] = src[j++] + value;
+
+        value_t *tmp = src;
+        src = dst;
+        dst = tmp;
+        size *= 2;
+    }
+
+    *sorted = src;
+    return true;
+}
+
+// ============================================================================
+// Куча слияния
+// ============================================================================
+
+static inline void heap_sift_down(MergeCursor *heap, size_t size, size_t index) {
+    MergeCursor item = heap[index];
+    for (;;) {
+        size_t child = 2 * index + 1;
+        if (child >= size) break;
+        if (child + 1 < size && heap[child + 1].value < heap[child].value) {
+            child++;
+        }
+        if (heap[child].value >= item.value) break;
+        heap[index] = heap[child];
+        index = child;
+    }
+    heap[index] = item;
+}
+
+// ============================================================================
+// Проверка
+// ============================================================================
+
+ExternalSumsResult external_sums_check(const value_t *elements, size_t count,
+                                       const ExternalSumsOptions *options) {
+    if (count == 0) {
+        return EXTERNAL_SUMS_DISTINCT;
+    }
+    if (count > 62) {
+        LOG_ERROR("Внешняя проверка не поддерживает n > 62");
+        return EXTERNAL_SUMS_ERROR;
+    }
+
+    // Суммы сравниваются в value_t - наибольшая не должна переполняться
+    value_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (__builtin_add_overflow(total, elements[i], &total)) {
+            LOG_ERROR("Внешняя проверка N=%zu: сумма элементов не помещается в 64 бита",
+                      count);
+            return EXTERNAL_SUMS_ERROR;
+        }
+    }
+
+    uint32_t run_log2 = options && options->run_log2 > 0 ?
+                        options->run_log2 : EXTERNAL_DEFAULT_RUN_LOG2;
+    const char *temp_dir = options ? options->temp_dir : NULL;
+
+    // Младшая часть - первые low элементов, старшая - остальные
+    size_t low = count < run_log2 ? count : run_log2;
+    size_t high = count - low;
+    size_t low_count = (size_t)1 << low;
+    size_t run_count = (size_t)1 << high;
+
+    value_t *mapping = map_temp_table(temp_dir, 2 * low_count);
+    if (!mapping) {
+        return EXTERNAL_SUMS_ERROR;
+    }
+
+    value_t *buffers[2] = { mapping, mapping + low_count };
+    value_t *table = NULL;
+    ExternalSumsResult result = build_low_table(buffers, elements, low, &table) ?
+                                EXTERNAL_SUMS_DISTINCT : EXTERNAL_SUMS_COLLISION;
+
+    value_t *bases = NULL;
+    MergeCursor *heap = NULL;
+    if (result == EXTERNAL_SUMS_DISTINCT && run_count > 1) {
+        bases = malloc(run_count * sizeof(value_t));
+        heap = malloc(run_count * sizeof(MergeCursor));
+        if (!bases || !heap) {
+            LOG_ERROR("Внешняя проверка N=%zu: не удалось выделить %zu прогонов",
+                      count, run_count);
+            result = EXTERNAL_SUMS_ERROR;
+        }
+    }
+
+    if (result == EXTERNAL_SUMS_DISTINCT && run_count > 1) {
+        // Сдвиги прогонов - суммы подмножеств старшей части (код Грея)
+        value_t base = 0;
+        uint64_t gray = 0;
+        bases[0] = 0;
+        for (size_t i = 1; i < run_count; i++) {
+            unsigned bit = (unsigned)__builtin_ctzll(i);
+            uint64_t mask = 1ULL << bit;
+            if (gray & mask) {
+                base -= elements[low + bit];
+            } else {
+                base += elements[low + bit];
+            }
+            gray ^= mask;
+            bases[i] = base;
+        }
+
+        // Куча по первым значениям прогонов (таблица начинается с 0)
+        for (size_t i = 0; i < run_count; i++) {
+            heap[i].value = bases[i];
+            heap[i].position = 0;
+            heap[i].run = i;
+        }
+        for (size_t i = run_count / 2; i-- > 0;) {
+            heap_sift_down(heap, run_count, i);
+        }
+
+        // k-путевое слияние: совпадение соседних значений - коллизия
+        size_t heap_size = run_count;
+        value_t previous = 0;
+        bool has_previous = false;
+        uint64_t merged = 0;
+        time_t last_log = time(NULL);
+
+        while (heap_size > 0) {
+            MergeCursor *top = &heap[0];
+            if (has_previous && top->value == previous) {
+                result = EXTERNAL_SUMS_COLLISION;
+                break;
+            }
+            previous = top->value;
+            has_previous = true;
+
+            if (++top->position < low_count) {
+                top->value = bases[top->run] + table[top->position];
+            } else {
+                heap[0] = heap[--heap_size];
+            }
+            heap_sift_down(heap, heap_size, 0);
+
+            // Периодический отчет о прогрессе
+            if ((++merged & 0xFFFFFF) == 0) {
+                time_t now = time(NULL);
+                if (now - last_log >= ERDOS_LOG_INTERVAL_SEC) {
+                    last_log = now;
+                    LOG_INFO("Внешняя проверка N=%zu: %.1f%% сумм",
+                             count, 100.0 * (double)merged / (double)(low_count * run_count));
+                }
+            }
+        }
+
+    }
+
+    free(heap);
+    free(bases);
+    munmap(mapping, 2 * low_count * sizeof(value_t));
+    return result;
+}
@@ -0,0 +1,310 @@
+/**
+ * joint_solver.c - Совместный поиск для диапазона N одним обходом дерева
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../include/joint_solver.h"
+#include "../include/backtrack_solver.h"
+#include "../include/logger.h"
+
+// ============================================================================
+// Цели
+// ============================================================================
+
+/**
+ * Бит цели k в маске
+ */
+static inline uint64_t target_bit(uint32_t k) {
+    return 1ULL << k;
+}
+
+/**
+ * Исключительная граница кандидата позиции depth для цели k:
+ * candidate + (k - depth - 1) < best_max[k]
+ */
+static inline value_t target_limit(const JointSolver *solver, uint32_t k, uint32_t depth) {
+    value_t best = solver->best_max[k];
+    uint32_t remaining = k - depth - 1;
+    return best > remaining ? best - remaining : 0;
+}
+
+/**
+ * Цели из alive, которые кандидат позиции depth не меньше from еще может
+ * улучшить; *limit - наибольшая из их границ кандидата (0 - целей нет)
+ */
+static uint64_t live_targets(const JointSolver *solver, uint64_t alive,
+                             uint32_t depth, value_t from, value_t *limit) {
+    uint64_t live = 0;
+    *limit = 0;
+    while (alive) {
+        uint32_t k = (uint32_t)__builtin_ctzll(alive);
+        alive &= alive - 1;
+
+        value_t target = target_limit(solver, k, depth);
+        if (from < target) {
+            live |= target_bit(k);
+            if (target > *limit) {
+                *limit = target;
+            }
+        }
+    }
+    return live;
+}
+
+/**
+ * Текущий префикс (depth элементов) - новое лучшее решение для k = depth
+ */
+static void record_solution(JointSolver *solver, uint32_t k) {
+    NumberSet *best = &solver->best_solutions[k];
+    subset_sum_manager_get_elements(solver->manager, best);
+    solver->best_max[k] = best->elements[k - 1];
+    log_solution_found(k, solver->best_max[k], best);
+}
+
+// ============================================================================
+// Создание и уничтожение
+// ============================================================================
+
+JointSolver* joint_solver_create(const SolverConfig *config, uint32_t min_n) {
+    JointSolver *solver = malloc(sizeof(JointSolver));
+    uint32_t n = config->n;
+
+    solver->config = *config;
+    solver->min_n = min_n >= 1 ? min_n : 1;
+    solver->targets = 0;
+    for (uint32_t k = solver->min_n; k <= n; k++) {
+        solver->targets |= target_bit(k);
+    }
+
+    // Без начального решения - граница степеней двойки, как у backtrack_solver
+    solver->best_max = calloc((size_t)n + 1, sizeof(value_t));
+    solver->best_solutions = malloc(((size_t)n + 1) * sizeof(NumberSet));
+    for (uint32_t k = 0; k <= n; k++) {
+        solver->best_max[k] = compute_initial_bound(k);
+        number_set_init(&solver->best_solutions[k], k);
+    }
+
+    // Элементы всех целей не превышают границы наибольшего N
+    value_t max_value = config->initial_bound > 0 ?
+                        config->initial_bound : compute_initial_bound(n);
+    solver->manager = subset_sum_manager_create_bounded(config->manager_type, n, max_value);
+    search_bounds_init(&solver->bounds, n, BOUND_RULES_ALL & ~config->disabled_bounds);
+    solver->frames = calloc((size_t)n + 1, sizeof(JointFrame));
+
+    solver->nodes_explored = 0;
+    solver->cuts = 0;
+    return solver;
+}
+
+void joint_solver_destroy(JointSolver *solver) {
+    if (!solver) return;
+
+    for (uint32_t k = 0; k <= solver->config.n; k++) {
+        number_set_clear(&solver->best_solutions[k]);
+    }
+    free(solver->best_solutions);
+    free(solver->best_max);
+    free(solver->frames);
+    search_bounds_destroy(&solver->bounds);
+    subset_sum_manager_destroy(solver->manager);
+    free(solver);
+}
+
+// ============================================================================
+// Настройка
+// ============================================================================
+
+void joint_solver_set_incumbent(JointSolver *solver, const NumberSet *set) {
+    size_t size = set->size <= solver->config.n ? set->size : solver->config.n;
+
+    for (size_t k = 1; k <= size; k++) {
+        // Префикс из k наименьших элементов, его максимум - k-й элемент
+        NumberSet *best = &solver->best_solutions[k];
+        value_t max_value = set->elements[k - 1];
+        if (best->size == k && solver->best_max[k] <= max_value) {
+            continue;
+        }
+
+        best->size = 0;
+        for (size_t i = 0; i < k; i++) {
+            number_set_push(best, set->elements[i]);
+        }
+        solver->best_max[k] = max_value;
+    }
+}
+
+void joint_solver_skip(JointSolver *solver, uint32_t n) {
+    if (n <= solver->config.n) {
+        solver->targets &= ~target_bit(n);
+    }
+}
+
+// ============================================================================
+// Обход
+// ============================================================================
+
+/**
+ * Выход из узла глубины depth (откат элемента)
+ * Возвращает false, если обход завершен
+ */
+static inline bool leave_node(JointSolver *solver, uint32_t *depth) {
+    if (*depth == 0) {
+        return false;
+    }
+    subset_sum_manager_remove_last(solver->manager);
+    (*depth)--;
+    return true;
+}
+
+/**
+ * Явный стек как в backtrack_solver: кадр глубины d - следующий кандидат
+ * на позицию d и маска живых целей узла. Возвращает true, если дерево
+ * обойдено полностью.
+ */
+static bool joint_search_run(JointSolver *solver, double start_time) {
+    JointFrame *frames = solver->frames;
+    uint32_t n = solver->config.n;
+    time_t last_log_time = time(NULL);
+
+    uint32_t depth = 0;
+    bool entering = true;
+    frames[0].next_candidate = 1;
+    frames[0].alive = solver->targets;
+
+    for (;;) {
+        if (solver->config.stop_flag && *solver->config.stop_flag) {
+            return false;
+        }
+
+        if (entering) {
+            entering = false;
+            solver->nodes_explored++;
+
+            // Периодическая проверка прогресса и ограничений запуска
+            uint64_t check_mask = solver->nodes_explored > 100000 ? 0xFFFF : 0x3FF;
+            if ((solver->nodes_explored & check_mask) == 0) {
+                double elapsed = get_time_sec() - start_time;
+                if (solver_config_budget_exhausted(&solver->config, elapsed,
+                                                   solver->nodes_explored)) {
+                    return false;
+                }
+                time_t now = time(NULL);
+                if (now - last_log_time >= solver->config.log_interval_sec) {
+                    last_log_time = now;
+                    log_progress(n, solver->nodes_explored, elapsed, depth, solver->best_max[n]);
+                }
+            }
+
+            // Префикс - новое решение для k = depth (кандидат прошел его границу)
+            uint64_t alive = frames[depth].alive;
+            if (alive & target_bit(depth)) {
+                record_solution(solver, depth);
+            }
+
+            // Дальше - только цели k > depth, прошедшие правила search_bounds
+            alive &= ~((2ULL << depth) - 1);
+            for (uint64_t rest = alive; rest; rest &= rest - 1) {
+                uint32_t k = (uint32_t)__builtin_ctzll(rest);
+                solver->bounds.n = k;
+                if (!search_bounds_feasible(&solver->bounds, depth, solver->best_max[k] - 1)) {
+                    alive &= ~target_bit(k);
+                }
+            }
+            frames[depth].alive = alive;
+
+            if (alive == 0) {
+                if (depth < n) {
+                    solver->cuts++;
+                }
+                if (!leave_node(solver, &depth)) {
+                    return true;
+                }
+                continue;
+            }
+        }
+
+        // Граница кандидата - наибольшая из границ живых целей; цели
+        // с границей не выше следующего кандидата умирают для узла
+        value_t limit;
+        uint64_t alive = live_targets(solver, frames[depth].alive, depth,
+                                      frames[depth].next_candidate, &limit);
+        frames[depth].alive = alive;
+
+        value_t candidate = alive != 0 ?
+                            subset_sum_manager_next_candidate(solver->manager,
+                                                              frames[depth].next_candidate,
+                                                              limit) : limit;
+        if (candidate >= limit) {
+            if (!leave_node(solver, &depth)) {
+                return true;
+            }
+            continue;
+        }
+        frames[depth].next_candidate = candidate + 1;
+
+        if (subset_sum_manager_add_element(solver->manager, candidate)) {
+            search_bounds_push(&solver->bounds, depth, candidate);
+            value_t child_limit;
+            frames[depth + 1].alive = live_targets(solver, alive, depth, candidate, &child_limit);
+            frames[depth + 1].next_candidate = candidate + 1;
+            depth++;
+            entering = true;
+        }
+    }
+}
+
+void joint_solver_solve(JointSolver *solver, SolutionResult *results) {
+    uint32_t n = solver->config.n;
+
+    if (solver->config.find_all_optimal || solver->config.first_only) {
+        LOG_WARNING("Совместный поиск не поддерживает --find-all и --first-only, "
+                    "ищется по одному оптимальному решению");
+    }
+
+    log_start(n, solver->best_max[n]);
+    LOG_INFO("Совместный поиск N=%u..%u: целей %d", solver->min_n, n,
+             __builtin_popcountll(solver->targets));
+
+    double start_time = get_time_sec();
+    bool complete = solver->targets == 0 || joint_search_run(solver, start_time);
+    double run_time = get_time_sec() - start_time;
+    bool stopped = solver->config.stop_flag && *solver->config.stop_flag;
+
+    // Менеджер хранит префикс прерванного обхода - сбрасываем
+    subset_sum_manager_reset(solver->manager);
+
+    for (uint64_t rest = solver->targets; rest; rest &= rest - 1) {
+        uint32_t k = (uint32_t)__builtin_ctzll(rest);
+        SolutionResult *result = &results[k - solver->min_n];
+        const NumberSet *best = &solver->best_solutions[k];
+        bool has_solution = best->size == k;
+
+        result->n = k;
+        if (has_solution) {
+            result->max_value = solver->best_max[k];
+            number_set_copy(&result->solution_set, best);
+        } else {
+            result->max_value = 0;
+            result->solution_set.size = 0;
+        }
+
+        if (!complete) {
+            result->status = stopped ? SOLUTION_STATUS_INTERRUPTED : SOLUTION_STATUS_TIMEOUT;
+        } else {
+            result->status = has_solution ? SOLUTION_STATUS_OPTIMAL
+                                           : SOLUTION_STATUS_NO_SOLUTION;
+        }
+        result->computation_time = run_time;
+        result->nodes_explored = solver->nodes_explored;
+        result->timestamp = time(NULL);
+
+        log_complete(k, result->status, run_time, solver->nodes_explored, result->max_value);
+    }
+
+    LOG_INFO("Совместный поиск: %llu узлов, %llu без живых целей",
+             (unsigned long long)solver->nodes_explored, (unsigned long long)solver->cuts);
+    solver->bounds.n = n;
+    search_bounds_log_stats(&solver->bounds);
+}
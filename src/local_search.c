@@ -0,0 +1,558 @@
+/**
+ * local_search.c - Локальный поиск (имитация отжига) верхних границ
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include "../include/local_search.h"
+#include "../include/logger.h"
+
+// ============================================================================
+// Константы
+// ============================================================================
+
+#define COORDINATOR_POLL_USEC 100000
+
+// Температура отжига: охлаждение за ход, по достижении минимума - нагрев заново
+#define ANNEAL_START_TEMPERATURE 2.0
+#define ANNEAL_MIN_TEMPERATURE   0.2
+#define ANNEAL_COOLING           0.99
+
+// Попыток выбрать значение хода, не занятое в множестве
+#define PROPOSAL_ATTEMPTS 16
+
+// Наибольший показатель паузы между точными проверками (N * 2^k ходов)
+#define CHECK_BACKOFF_MAX_LOG2 12
+
+// Суммы окна без одного элемента
+#define WINDOW_SUMS_SIZE ((size_t)1 << (LOCAL_SEARCH_WINDOW - 1))
+
+// ============================================================================
+// Случайные числа (xorshift64*, свой генератор у каждого потока)
+// ============================================================================
+
+static inline uint64_t rng_next(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * Равномерно из [lo, hi]
+ */
+static inline value_t rng_range(uint64_t *state, value_t lo, value_t hi) {
+    return lo + rng_next(state) % (hi - lo + 1);
+}
+
+/**
+ * Равномерно из [0, 1)
+ */
+static inline double rng_unit(uint64_t *state) {
+    return (double)(rng_next(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// ============================================================================
+// Коллизии в окне
+// ============================================================================
+
+/**
+ * Случайное окно из m индексов; first (если < n) всегда входит первым
+ * Частичная перетасовка worker->order, окно - его первые m индексов.
+ */
+static const uint32_t* pick_window(LocalSearchWorker *worker, uint32_t n,
+                                   uint32_t m, uint32_t first) {
+    uint32_t *order = worker->order;
+    uint32_t start = 0;
+
+    if (first < n) {
+        for (uint32_t i = 0; i < n; i++) {
+            if (order[i] == first) {
+                order[i] = order[0];
+                order[0] = first;
+                break;
+            }
+        }
+        start = 1;
+    }
+
+    for (uint32_t i = start; i < m; i++) {
+        uint32_t j = i + (uint32_t)(rng_next(&worker->rng) % (n - i));
+        uint32_t swap = order[i];
+        order[i] = order[j];
+        order[j] = swap;
+    }
+    return order;
+}
+
+/**
+ * Отсортированные суммы подмножеств count элементов окна в worker->sums
+ * Слияние сумм и сумм + v двумя указателями, как у менеджера Sorted:
+ * 2^count значений с повторами, доступ к памяти последовательный.
+ */
+static size_t window_sums(LocalSearchWorker *worker, const uint32_t *window,
+                          uint32_t count) {
+    value_t *sums = worker->sums;
+    value_t *next = worker->scratch;
+    size_t len = 1;
+    sums[0] = 0;
+
+    for (uint32_t k = 0; k < count; k++) {
+        value_t value = worker->elements[window[k]];
+        size_t i = 0, j = 0, out = 0;
+        while (i < len) {
+            // Без ветвлений: сравнение сумм непредсказуемо
+            value_t current = sums[i];
+            value_t shifted = sums[j] + value;
+            bool take = current <= shifted;
+            next[out++] = take ? current : shifted;
+            i += take;
+            j += !take;
+        }
+        while (j < len) {
+            next[out++] = sums[j++] + value;
+        }
+        value_t *swap = sums;
+        sums = next;
+        next = swap;
+        len = out;
+    }
+
+    worker->sums = sums;
+    worker->scratch = next;
+    return len;
+}
+
+/**
+ * Коллизии сумм окна {sums} + {0, value}: sum_s max(0, count[s] - 1)
+ * Слияние без записи, равные соседи - коллизии.
+ */
+static uint64_t merged_collisions(const value_t *sums, size_t len, value_t value) {
+    uint64_t collisions = 0;
+    value_t previous = sums[0];
+    size_t i = 1, j = 0;
+
+    while (i < len) {
+        value_t low = sums[i];
+        value_t shifted = sums[j] + value;
+        bool take = low <= shifted;
+        value_t current = take ? low : shifted;
+        i += take;
+        j += !take;
+        collisions += current == previous;
+        previous = current;
+    }
+    while (j < len) {
+        value_t current = sums[j++] + value;
+        collisions += current == previous;
+        previous = current;
+    }
+    return collisions;
+}
+
+/**
+ * Коллизии окна из m элементов
+ */
+static uint64_t window_collisions(LocalSearchWorker *worker, const uint32_t *window,
+                                  uint32_t m) {
+    size_t len = window_sums(worker, window + 1, m - 1);
+    return merged_collisions(worker->sums, len, worker->elements[window[0]]);
+}
+
+/**
+ * Коллизии в окнах хода: до и после замены elements[index] на value
+ * Окна одни и те же, поэтому разность - изменение коллизий в них; суммы
+ * остальных элементов окна строятся один раз для обоих значений.
+ * Возвращает коллизии после замены, *delta - изменение.
+ */
+static uint64_t apply_move(LocalSearchWorker *worker, uint32_t n, uint32_t index,
+                           value_t value, int64_t *delta) {
+    uint32_t m = n < LOCAL_SEARCH_WINDOW ? n : LOCAL_SEARCH_WINDOW;
+    uint32_t windows = m == n ? 1 : LOCAL_SEARCH_MOVE_WINDOWS;
+    value_t old_value = worker->elements[index];
+
+    uint64_t before = 0;
+    uint64_t after = 0;
+    for (uint32_t w = 0; w < windows; w++) {
+        const uint32_t *window = pick_window(worker, n, m, index);
+        size_t len = window_sums(worker, window + 1, m - 1);
+        before += merged_collisions(worker->sums, len, old_value);
+        after += merged_collisions(worker->sums, len, value);
+    }
+    worker->elements[index] = value;
+
+    *delta = (int64_t)after - (int64_t)before;
+    return after;
+}
+
+/**
+ * Отсев перед точной проверкой: нет коллизий в случайных окнах
+ */
+static bool screen_windows(LocalSearchWorker *worker, uint32_t n) {
+    uint32_t m = n < LOCAL_SEARCH_WINDOW ? n : LOCAL_SEARCH_WINDOW;
+    uint32_t windows = m == n ? 1 : LOCAL_SEARCH_SCREEN_WINDOWS;
+    for (uint32_t w = 0; w < windows; w++) {
+        const uint32_t *window = pick_window(worker, n, m, n);
+        if (window_collisions(worker, window, m) > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// Состояние потока
+// ============================================================================
+
+static bool contains(const value_t *elements, uint32_t n, value_t value) {
+    for (uint32_t i = 0; i < n; i++) {
+        if (elements[i] == value) return true;
+    }
+    return false;
+}
+
+/**
+ * Свободное значение из [1, target] вне множества (0 - не нашлось)
+ */
+static value_t random_free_value(LocalSearchWorker *worker, uint32_t n) {
+    for (int attempt = 0; attempt < PROPOSAL_ATTEMPTS; attempt++) {
+        value_t value = rng_range(&worker->rng, 1, worker->target);
+        if (!contains(worker->elements, n, value)) return value;
+    }
+    return 0;
+}
+
+/**
+ * Значение хода для элемента old_value: равномерное из [1, target]
+ * или сдвиг в окрестности old_value (0 - не нашлось)
+ */
+static value_t propose_value(LocalSearchWorker *worker, uint32_t n, value_t old_value) {
+    if (rng_next(&worker->rng) & 1) {
+        return random_free_value(worker, n);
+    }
+
+    value_t radius = worker->target / 32 > 0 ? worker->target / 32 : 1;
+    for (int attempt = 0; attempt < PROPOSAL_ATTEMPTS; attempt++) {
+        value_t lo = old_value > radius ? old_value - radius : 1;
+        value_t hi = old_value + radius < worker->target ? old_value + radius : worker->target;
+        value_t value = rng_range(&worker->rng, lo, hi);
+        if (value != old_value && !contains(worker->elements, n, value)) return value;
+    }
+    return 0;
+}
+
+/**
+ * Понижение цели: элементы больше target заменяются свободными значениями
+ */
+static void shrink_to_target(LocalSearchWorker *worker, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        if (worker->elements[i] > worker->target) {
+            value_t value = random_free_value(worker, n);
+            while (value == 0) {
+                value = rng_range(&worker->rng, 1, worker->target);
+                if (contains(worker->elements, n, value)) value = 0;
+            }
+            worker->elements[i] = value;
+        }
+    }
+}
+
+/**
+ * Точная проверка текущего множества и публикация, если оно лучше общего
+ */
+static void verify_and_publish(LocalSearchWorker *worker) {
+    LocalSearch *search = worker->owner;
+    uint32_t n = search->config.n;
+
+    // Множество хранится по возрастанию, как у точного решателя
+    NumberSet candidate;
+    number_set_init(&candidate, n);
+    for (uint32_t i = 0; i < n; i++) {
+        size_t j = candidate.size++;
+        while (j > 0 && candidate.elements[j - 1] > worker->elements[i]) {
+            candidate.elements[j] = candidate.elements[j - 1];
+            j--;
+        }
+        candidate.elements[j] = worker->elements[i];
+    }
+    value_t max_value = number_set_max(&candidate);
+
+    // Общий максимум мог уже опуститься ниже - проверять незачем
+    BSequenceCheck check = B_SEQUENCE_UNKNOWN;
+    pthread_mutex_lock(&search->check_lock);
+    if (max_value < atomic_load(&search->best_max)) {
+        check = check_b_sequence(&candidate);
+        atomic_fetch_add_explicit(&worker->checks, 1, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&search->check_lock);
+
+    if (check != B_SEQUENCE_VALID) {
+        // Соотношение вне окон: отсев пропустил, проверка - нет
+        if (check == B_SEQUENCE_INVALID) {
+            atomic_fetch_add_explicit(&worker->rejected, 1, memory_order_relaxed);
+            if (worker->failures < CHECK_BACKOFF_MAX_LOG2) {
+                worker->failures++;
+            }
+        }
+        worker->cooldown = (uint64_t)n << worker->failures;
+        number_set_clear(&candidate);
+        return;
+    }
+    worker->failures = 0;
+
+    pthread_mutex_lock(&search->lock);
+    if (max_value < atomic_load_explicit(&search->best_max, memory_order_relaxed)) {
+        number_set_copy(&search->best_solution, &candidate);
+        atomic_store_explicit(&search->best_max, max_value, memory_order_relaxed);
+        search->improvements++;
+        LOG_INFO("Локальный поиск N=%u: max=%" PRIu64 ", ходов=%llu", n, max_value,
+                 (unsigned long long)atomic_load_explicit(&worker->moves, memory_order_relaxed));
+
+        if (search->improvement_callback) {
+            search->improvement_callback(n, max_value, &search->best_solution,
+                                         search->callback_user_data);
+        }
+    }
+    pthread_mutex_unlock(&search->lock);
+    number_set_clear(&candidate);
+}
+
+static void* worker_main(void *arg) {
+    LocalSearchWorker *worker = (LocalSearchWorker *)arg;
+    LocalSearch *search = worker->owner;
+    uint32_t n = search->config.n;
+
+    // Старт от общего лучшего множества под целью на единицу ниже
+    pthread_mutex_lock(&search->lock);
+    memcpy(worker->elements, search->best_solution.elements, n * sizeof(value_t));
+    worker->target = atomic_load_explicit(&search->best_max, memory_order_relaxed) - 1;
+    pthread_mutex_unlock(&search->lock);
+    if (worker->target < n) {
+        return NULL;
+    }
+    shrink_to_target(worker, n);
+
+    double temperature = ANNEAL_START_TEMPERATURE;
+    while (!search->stop) {
+        // Цель следует за общим лучшим максимумом
+        value_t best = atomic_load_explicit(&search->best_max, memory_order_relaxed);
+        if (best - 1 < worker->target) {
+            worker->target = best - 1;
+            if (worker->target < n) break;
+            shrink_to_target(worker, n);
+        }
+
+        uint32_t index = (uint32_t)(rng_next(&worker->rng) % n);
+        value_t old_value = worker->elements[index];
+        value_t value = propose_value(worker, n, old_value);
+        if (value == 0) continue;
+
+        int64_t delta;
+        bool clean = apply_move(worker, n, index, value, &delta) == 0;
+        if (delta > 0 && rng_unit(&worker->rng) >= exp(-(double)delta / temperature)) {
+            worker->elements[index] = old_value;
+            clean = false;
+        }
+        atomic_fetch_add_explicit(&worker->moves, 1, memory_order_relaxed);
+        if (worker->cooldown > 0) {
+            worker->cooldown--;
+        }
+
+        // Окна хода без коллизий - отсев и точная проверка
+        if (clean && worker->cooldown == 0 && screen_windows(worker, n)) {
+            verify_and_publish(worker);
+            temperature = ANNEAL_START_TEMPERATURE;
+            continue;
+        }
+
+        temperature *= ANNEAL_COOLING;
+        if (temperature < ANNEAL_MIN_TEMPERATURE) {
+            temperature = ANNEAL_START_TEMPERATURE;
+        }
+    }
+
+    return NULL;
+}
+
+// ============================================================================
+// Создание и уничтожение
+// ============================================================================
+
+LocalSearch* local_search_create(const SolverConfig *config, uint32_t thread_count) {
+    LocalSearch *search = malloc(sizeof(LocalSearch));
+    search->config = *config;
+
+    if (thread_count == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = cpus > 0 ? (uint32_t)cpus : 1;
+    }
+    search->thread_count = thread_count;
+    search->workers = calloc(thread_count, sizeof(LocalSearchWorker));
+
+    number_set_init(&search->incumbent, config->n);
+    number_set_init(&search->best_solution, config->n);
+    atomic_store(&search->best_max, 0);
+    pthread_mutex_init(&search->lock, NULL);
+    pthread_mutex_init(&search->check_lock, NULL);
+    search->improvements = 0;
+    search->stop = false;
+
+    search->improvement_callback = NULL;
+    search->callback_user_data = NULL;
+
+    return search;
+}
+
+void local_search_destroy(LocalSearch *search) {
+    if (!search) return;
+
+    free(search->workers);
+    number_set_clear(&search->incumbent);
+    number_set_clear(&search->best_solution);
+    pthread_mutex_destroy(&search->lock);
+    pthread_mutex_destroy(&search->check_lock);
+    free(search);
+}
+
+void local_search_set_incumbent(LocalSearch *search, const NumberSet *set) {
+    number_set_copy(&search->incumbent, set);
+}
+
+void local_search_set_improvement_callback(LocalSearch *search,
+                                           SolutionCallback callback,
+                                           void *user_data) {
+    search->improvement_callback = callback;
+    search->callback_user_data = user_data;
+}
+
+// ============================================================================
+// Поиск
+// ============================================================================
+
+/**
+ * Счетчики всех потоков: ходы, точные проверки, из них не прошли
+ */
+static void total_counters(const LocalSearch *search, uint32_t threads,
+                           uint64_t *moves, uint64_t *checks, uint64_t *rejected) {
+    *moves = *checks = *rejected = 0;
+    for (uint32_t i = 0; i < threads; i++) {
+        const LocalSearchWorker *worker = &search->workers[i];
+        *moves += atomic_load_explicit(&worker->moves, memory_order_relaxed);
+        *checks += atomic_load_explicit(&worker->checks, memory_order_relaxed);
+        *rejected += atomic_load_explicit(&worker->rejected, memory_order_relaxed);
+    }
+}
+
+void local_search_solve(LocalSearch *search, SolutionResult *result) {
+    uint32_t n = search->config.n;
+
+    // Начало - инкумбент или степени двойки (суммы различны, max = 2^(N-1))
+    NumberSet *best = &search->best_solution;
+    if (search->incumbent.size == n) {
+        number_set_copy(best, &search->incumbent);
+    } else {
+        best->size = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            number_set_push(best, 1ULL << i);
+        }
+    }
+    atomic_store(&search->best_max, number_set_max(best));
+    search->improvements = 0;
+    search->stop = false;
+
+    // Целевой максимум не меньше N - иначе N различных значений не поместятся
+    uint32_t threads = n >= 2 && number_set_max(best) > n ? search->thread_count : 0;
+
+    double time_limit = search->config.time_limit_sec;
+    if (time_limit <= 0 && search->config.node_limit == 0) {
+        time_limit = LOCAL_SEARCH_DEFAULT_TIME_SEC;
+    }
+
+    LOG_INFO("N=%u: локальный поиск от max=%" PRIu64 ", потоков=%u, время=%.0fs",
+             n, number_set_max(best), threads, time_limit);
+
+    double start_time = get_time_sec();
+    time_t last_log = time(NULL);
+    uint64_t seed = (uint64_t)time(NULL) ^ ((uint64_t)n << 32);
+
+    for (uint32_t i = 0; i < threads; i++) {
+        LocalSearchWorker *worker = &search->workers[i];
+        worker->owner = search;
+        worker->rng = (seed + 0x9E3779B97F4A7C15ULL * (i + 1)) | 1;
+        worker->elements = malloc(n * sizeof(value_t));
+        worker->order = malloc(n * sizeof(uint32_t));
+        for (uint32_t j = 0; j < n; j++) {
+            worker->order[j] = j;
+        }
+        worker->sums = malloc(WINDOW_SUMS_SIZE * sizeof(value_t));
+        worker->scratch = malloc(WINDOW_SUMS_SIZE * sizeof(value_t));
+        worker->cooldown = 0;
+        worker->failures = 0;
+        atomic_store(&worker->moves, 0);
+        atomic_store(&worker->checks, 0);
+        atomic_store(&worker->rejected, 0);
+        pthread_create(&worker->thread, NULL, worker_main, worker);
+    }
+
+    // Координатор: остановка по сигналу и ограничениям запуска, прогресс
+    bool interrupted = false;
+    uint64_t moves, checks, rejected;
+    while (threads > 0 && !search->stop) {
+        usleep(COORDINATOR_POLL_USEC);
+
+        double elapsed = get_time_sec() - start_time;
+        total_counters(search, threads, &moves, &checks, &rejected);
+        if (search->config.stop_flag && *search->config.stop_flag) {
+            interrupted = true;
+            search->stop = true;
+        } else if ((time_limit > 0 && elapsed >= time_limit) ||
+                   (search->config.node_limit > 0 && moves >= search->config.node_limit)) {
+            search->stop = true;
+        }
+
+        time_t now = time(NULL);
+        if (now - last_log >= search->config.log_interval_sec) {
+            last_log = now;
+            LOG_INFO("N=%u: ходов=%llu, проверок=%llu, time=%.1fs, max=%" PRIu64,
+                     n, (unsigned long long)moves, (unsigned long long)checks, elapsed,
+                     atomic_load_explicit(&search->best_max, memory_order_relaxed));
+        }
+    }
+
+    for (uint32_t i = 0; i < threads; i++) {
+        LocalSearchWorker *worker = &search->workers[i];
+        pthread_join(worker->thread, NULL);
+        free(worker->elements);
+        free(worker->order);
+        free(worker->sums);
+        free(worker->scratch);
+    }
+
+    double elapsed = get_time_sec() - start_time;
+    total_counters(search, threads, &moves, &checks, &rejected);
+
+    // Без улучшений результата нет: начальное множество найдено не поиском
+    result->n = n;
+    if (search->improvements > 0) {
+        result->max_value = number_set_max(best);
+        number_set_copy(&result->solution_set, best);
+        result->status = interrupted ? SOLUTION_STATUS_INTERRUPTED : SOLUTION_STATUS_FEASIBLE;
+    } else {
+        result->max_value = 0;
+        result->solution_set.size = 0;
+        result->status = interrupted ? SOLUTION_STATUS_INTERRUPTED : SOLUTION_STATUS_NO_SOLUTION;
+    }
+    result->computation_time = elapsed;
+    result->nodes_explored = moves;
+    result->timestamp = time(NULL);
+
+    log_complete(n, result->status, elapsed, result->nodes_explored, result->max_value);
+    LOG_INFO("N=%u: локальный поиск - %u улучшений, точных проверок %llu, не прошли %llu",
+             n, search->improvements, (unsigned long long)checks,
+             (unsigned long long)rejected);
+}
@@ -162,6 +162,14 @@ void log_complete(uint32_t n, SolutionStatus status, double total_time,
         log_message(LOG_LEVEL_INFO,
                     "Interrupted N=%u, nodes=%s, time=%.2fs",
                     n, nodes_str, total_time);
+    } else if (status == SOLUTION_STATUS_FEASIBLE) {
+        log_message(LOG_LEVEL_INFO,
+                    "Found N=%u, max=%" PRIu64 " (not proven optimal), nodes=%s, time=%.2fs",
+                    n, max_value, nodes_str, total_time);
+    } else if (status == SOLUTION_STATUS_TIMEOUT) {
+        log_message(LOG_LEVEL_INFO,
+                    "Paused N=%u, best=%" PRIu64 ", nodes=%s, time=%.2fs",
+                    n, max_value, nodes_str, total_time);
     } else {
         log_message(LOG_LEVEL_INFO,
                     "No solution for N=%u, nodes=%s, time=%.2fs",
@@ -17,7 +17,15 @@
 #include "../include/logger.h"
 #include "../include/subset_sum_manager.h"
 #include "../include/backtrack_solver.h"
+#include "../include/parallel_solver.h"
+#include "../include/decision_solver.h"
+#include "../include/local_search.h"
+#include "../include/search_bounds.h"
+#include "../include/constructions.h"
 #include "../include/db_manager.h"
+#include "../include/optimal_writer.h"
+#include "../include/bound_board.h"
+#include "../include/joint_solver.h"
 
 // ============================================================================
 // Глобальные переменные
@@ -26,6 +34,31 @@
 static volatile bool g_stop_flag = false;
 static pthread_mutex_t g_result_mutex = PTHREAD_MUTEX_INITIALIZER;
 static DatabaseManager *g_db_manager = NULL;
+static BoundBoard *g_bound_board = NULL;  // Границы одновременно решаемых N (run_range)
+
+/**
+ * Общие настройки решателя из CLI (одинаковые для всех воркеров)
+ */
+typedef struct {
+    bool manager_forced;           // Тип менеджера задан явно
+    ManagerType manager_type;      // Явно заданный тип менеджера
+    uint32_t threads;              // Потоков на одно N (1 = последовательно, 0 = все ядра)
+    uint32_t split_depth;          // Длина префикса задачи параллельного поиска
+    uint32_t checkpoint_interval;  // Период контрольных точек, сек (0 = выключены)
+    uint32_t bounds;               // Включенные правила отсечения (маска)
+    bool no_seed;                  // Не строить начальное решение
+    bool decision;                 // Распознавание по возрастанию максимума
+    bool local_search;             // Локальный поиск верхней границы вместо перебора
+    SearchOrder order;             // Порядок построения множества
+    uint32_t nogood_cache_mb;      // Размер кеша тупиков, МБ (0 = выключен)
+    double time_limit_sec;         // Ограничение времени на N, сек (0 = нет)
+    uint64_t node_limit;           // Ограничение узлов на N (0 = нет)
+} SolveSettings;
+
+// Узлов за один вызов backtrack_solver_run между проверками контрольной точки
+#define CHECKPOINT_NODE_SLICE (1ULL << 20)
+
+static SolveSettings g_settings = {0};
 
 // ============================================================================
 // Структуры для параллельного выполнения
@@ -70,6 +103,342 @@ static void setup_signal_handlers(void) {
 // Функция воркера
 // ============================================================================
 
+/**
+ * Выдача оптимального множества решателем в очередь записи
+ */
+static void stream_optimal_set(uint32_t n, const NumberSet *set, void *user_data) {
+    (void)n;
+    optimal_writer_push((OptimalWriter *)user_data, set);
+}
+
+/**
+ * Публикация решения на доске границ (callback решателей)
+ */
+static void publish_bound(uint32_t n, value_t max_value, const NumberSet *solution,
+                          void *user_data) {
+    (void)n;
+    (void)max_value;
+    (void)user_data;
+    bound_board_publish(g_bound_board, solution);
+}
+
+/**
+ * Сохранение улучшения локального поиска сразу при нахождении
+ * Множество уже проверено check_b_sequence.
+ */
+static void save_improvement(uint32_t n, value_t max_value, const NumberSet *solution,
+                             void *user_data) {
+    (void)user_data;
+    if (g_bound_board) {
+        bound_board_publish(g_bound_board, solution);
+    }
+    if (!g_db_manager) return;
+
+    SolutionResult result = {
+        .n = n,
+        .max_value = max_value,
+        .solution_set = *solution,
+        .status = SOLUTION_STATUS_FEASIBLE,
+        .timestamp = time(NULL)
+    };
+    pthread_mutex_lock(&g_result_mutex);
+    db_manager_save_result(g_db_manager, &result);
+    pthread_mutex_unlock(&g_result_mutex);
+}
+
+/**
+ * Сведение результата с доской границ
+ * Граница N могла прийти от решения другого N (префикс множества N+1):
+ * если ее множество лучше найденного, а перебор завершился под ней,
+ * оно оптимально. Итог публикуется, оптимум поднимает нижние границы.
+ */
+static void settle_with_board(uint32_t n, SolutionResult *result) {
+    NumberSet known;
+    number_set_init(&known, n);
+    if (bound_board_get(g_bound_board, n, &known) &&
+        (result->solution_set.size == 0 || number_set_max(&known) < result->max_value)) {
+        bool complete = result->status == SOLUTION_STATUS_OPTIMAL ||
+                        result->status == SOLUTION_STATUS_NO_SOLUTION;
+        LOG_INFO("N=%u: решение с доски границ, max=%" PRIu64 "%s",
+                 n, number_set_max(&known), complete ? " (оптимально)" : "");
+        number_set_copy(&result->solution_set, &known);
+        result->max_value = number_set_max(&known);
+        if (complete) {
+            result->status = SOLUTION_STATUS_OPTIMAL;
+        }
+    }
+    number_set_clear(&known);
+
+    if (result->solution_set.size == n) {
+        bound_board_publish(g_bound_board, &result->solution_set);
+    }
+    if (result->status == SOLUTION_STATUS_OPTIMAL) {
+        bound_board_set_optimal(g_bound_board, n, result->max_value);
+    }
+}
+
+/**
+ * Сохранение результата и всех оптимальных множеств в БД
+ * Множества из очереди записи дописываются до статуса OPTIMAL в results.
+ * Незавершенный поиск (ограничение запуска, остановка) сохраняет лучшее
+ * найденное множество: следующий запуск начнет с него.
+ */
+static void save_worker_result(const WorkerTask *task, SolutionResult *result,
+                               OptimalWriter *writer,
+                               NumberSet *optimal_sets, size_t optimal_count) {
+    if (g_bound_board) {
+        settle_with_board(task->n, result);
+    }
+
+    if (writer) {
+        optimal_writer_close(writer);
+        if (result->status == SOLUTION_STATUS_OPTIMAL) {
+            // Перебор завершен: предварительные множества с оптимумом - оптимальные
+            db_manager_promote_pending_sets(g_db_manager, task->n, result->max_value);
+            if (writer->persisted_max == result->max_value) {
+                LOG_INFO("N=%u: записано %zu оптимальных множеств с max=%" PRIu64,
+                         task->n, writer->persisted_count, writer->persisted_max);
+            }
+        } else if (!db_manager_has_checkpoint(g_db_manager, task->n)) {
+            // Продолжить перебор нельзя - множества не доказаны и не нужны
+            db_manager_discard_pending_sets(g_db_manager, task->n);
+        } else if (writer->persisted_max != 0) {
+            LOG_INFO("N=%u: %zu предварительных множеств с max=%" PRIu64
+                     " сохранены до продолжения поиска",
+                     task->n, writer->persisted_count, writer->persisted_max);
+        }
+    }
+
+    if (!g_db_manager || result->solution_set.size == 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&g_result_mutex);
+    db_manager_save_result(g_db_manager, result);
+
+    // Сохраняем все оптимальные решения если нужно
+    if (task->find_all_optimal && optimal_count > 0 &&
+        result->status == SOLUTION_STATUS_OPTIMAL) {
+        db_manager_save_optimal_sets(g_db_manager, task->n, optimal_sets, optimal_count);
+    }
+    pthread_mutex_unlock(&g_result_mutex);
+}
+
+/**
+ * Последовательный поиск с контрольными точками
+ * Продолжает поиск с сохраненной точки, если она есть, периодически
+ * сохраняет состояние и сохраняет его при остановке по сигналу.
+ * Завершенный поиск удаляет свою точку.
+ */
+static void solve_with_checkpoints(const WorkerTask *task, BacktrackSolver *solver,
+                                   SolutionResult *result) {
+    // Точка хранит стек без порядка построения - только снизу вверх
+    bool checkpoints = g_db_manager && g_settings.checkpoint_interval > 0 &&
+                       solver->config.order == SEARCH_ORDER_ASCENDING;
+    SearchCheckpoint checkpoint;
+    search_checkpoint_init(&checkpoint);
+
+    bool resumed = false;
+    if (checkpoints && db_manager_load_checkpoint(g_db_manager, task->n, &checkpoint)) {
+        if (checkpoint.find_all_optimal != task->find_all_optimal) {
+            LOG_WARNING("N=%u: контрольная точка другого режима поиска, начинаем заново",
+                        task->n);
+        } else if (!backtrack_solver_restore_checkpoint(solver, &checkpoint)) {
+            LOG_WARNING("N=%u: контрольная точка не подходит, начинаем заново", task->n);
+        } else {
+            resumed = true;
+            LOG_INFO("N=%u: продолжаем с контрольной точки (%" PRIu64 " узлов, глубина %zu)",
+                     task->n, checkpoint.nodes_explored, checkpoint.elements.size);
+        }
+    }
+    if (!resumed) {
+        backtrack_solver_begin(solver);
+    }
+
+    time_t last_checkpoint = time(NULL);
+    while (!backtrack_solver_run(solver, CHECKPOINT_NODE_SLICE)) {
+        if (*task->stop_flag || backtrack_solver_budget_exhausted(solver)) {
+            break;
+        }
+
+        time_t now = time(NULL);
+        if (checkpoints && now - last_checkpoint >= (time_t)g_settings.checkpoint_interval) {
+            last_checkpoint = now;
+            backtrack_solver_save_checkpoint(solver, &checkpoint);
+            db_manager_save_checkpoint(g_db_manager, &checkpoint);
+            LOG_DEBUG("N=%u: контрольная точка сохранена", task->n);
+        }
+    }
+
+    if (checkpoints) {
+        if (backtrack_solver_is_finished(solver)) {
+            db_manager_delete_checkpoint(g_db_manager, task->n);
+        } else {
+            // Остановка по сигналу или ограничению - последняя точка перед выходом
+            backtrack_solver_save_checkpoint(solver, &checkpoint);
+            if (db_manager_save_checkpoint(g_db_manager, &checkpoint)) {
+                LOG_INFO("N=%u: состояние поиска сохранено, запустите снова для продолжения",
+                         task->n);
+            }
+        }
+    }
+    search_checkpoint_clear(&checkpoint);
+
+    backtrack_solver_finish(solver, result);
+
+    if (task->find_all_optimal) {
+        LOG_INFO("Найдено %zu оптимальных решений для N=%u",
+                 backtrack_solver_optimal_total(solver), task->n);
+    }
+}
+
+/**
+ * Поиск обоими порядками построения поочередно (SEARCH_ORDER_AUTO)
+ * Решатели по очереди получают CHECKPOINT_NODE_SLICE узлов, результат дает
+ * первый завершившийся: время не больше удвоенного времени лучшего порядка.
+ * Ограничение узлов действует на каждый порядок отдельно.
+ * Возвращает решатель результата (при остановке - с лучшим максимумом).
+ */
+static BacktrackSolver* solve_race(const WorkerTask *task, BacktrackSolver *solvers[2],
+                                   SolutionResult *result) {
+    backtrack_solver_begin(solvers[0]);
+    backtrack_solver_begin(solvers[1]);
+
+    BacktrackSolver *winner = NULL;
+    while (!winner && !*task->stop_flag &&
+           !(backtrack_solver_budget_exhausted(solvers[0]) &&
+             backtrack_solver_budget_exhausted(solvers[1]))) {
+        for (int i = 0; i < 2 && !winner; i++) {
+            if (backtrack_solver_run(solvers[i], CHECKPOINT_NODE_SLICE)) {
+                winner = solvers[i];
+            }
+        }
+    }
+
+    if (winner) {
+        const BacktrackSolver *loser = winner == solvers[0] ? solvers[1] : solvers[0];
+        LOG_INFO("N=%u: порядок %s быстрее (%" PRIu64 " узлов, %s - не завершен за %" PRIu64 ")",
+                 task->n, search_order_to_string(winner->config.order),
+                 winner->stats.nodes_explored, search_order_to_string(loser->config.order),
+                 loser->stats.nodes_explored);
+    } else {
+        winner = solvers[1]->has_solution &&
+                 (!solvers[0]->has_solution || solvers[1]->best_max < solvers[0]->best_max) ?
+                 solvers[1] : solvers[0];
+    }
+
+    backtrack_solver_finish(winner, result);
+
+    if (task->find_all_optimal) {
+        LOG_INFO("Найдено %zu оптимальных решений для N=%u",
+                 backtrack_solver_optimal_total(winner), task->n);
+    }
+    return winner;
+}
+
+/**
+ * Продолжение сохраненных множеств N-1 (оптимальные и лучшее известное)
+ * до N-множества; лучшее инкумбента заменяет его
+ */
+static void seed_from_smaller(uint32_t n, NumberSet *incumbent) {
+    NumberSet *sources = NULL;
+    size_t count = db_manager_get_optimal_sets(g_db_manager, n - 1, &sources);
+
+    SolutionResult known;
+    solution_result_init(&known);
+    if (db_manager_get_best_known(g_db_manager, n - 1, &known) &&
+        known.solution_set.size == n - 1) {
+        sources = realloc(sources, (count + 1) * sizeof(NumberSet));
+        number_set_init(&sources[count], n - 1);
+        number_set_copy(&sources[count], &known.solution_set);
+        count++;
+    }
+    solution_result_clear(&known);
+
+    NumberSet extended;
+    number_set_init(&extended, n);
+    value_t bound = incumbent->size > 0 ? number_set_max(incumbent) : 0;
+    if (count > 0 && extend_smaller_sets(n, sources, count, bound, &extended)) {
+        number_set_copy(incumbent, &extended);
+        LOG_INFO("N=%u: начальное решение из множеств N=%u, max=%" PRIu64,
+                 n, n - 1, number_set_max(&extended));
+    }
+    number_set_clear(&extended);
+
+    for (size_t i = 0; i < count; i++) {
+        number_set_clear(&sources[i]);
+    }
+    free(sources);
+}
+
+/**
+ * Начальное решение N - лучшее из БД (в том числе незавершенных запусков),
+ * конструкция Конвея - Гая или продолжение множеств N-1, если они лучше
+ * (incumbent->size = 0 - решения нет)
+ */
+static void build_incumbent(uint32_t n, NumberSet *incumbent) {
+    incumbent->size = 0;
+
+    SolutionResult known;
+    solution_result_init(&known);
+    if (g_db_manager && db_manager_get_best_known(g_db_manager, n, &known) &&
+        known.solution_set.size == n) {
+        switch (check_b_sequence(&known.solution_set)) {
+            case B_SEQUENCE_VALID:
+                number_set_copy(incumbent, &known.solution_set);
+                LOG_INFO("N=%u: начальное решение из БД (%s), max=%" PRIu64,
+                         n, solution_status_to_string(known.status), known.max_value);
+                break;
+            case B_SEQUENCE_INVALID:
+                LOG_WARNING("N=%u: множество из БД (max=%" PRIu64 ") имеет равные суммы "
+                            "подмножеств, не используется", n, known.max_value);
+                break;
+            case B_SEQUENCE_UNKNOWN:
+                // Непроверенное множество не может стать решением: перебор
+                // начнется с других инкумбентов и сам найдет его, если оно верно
+                LOG_WARNING("N=%u: множество из БД (max=%" PRIu64 ") не удалось проверить, "
+                            "не используется как начальное решение", n, known.max_value);
+                break;
+        }
+    }
+    solution_result_clear(&known);
+
+    NumberSet seed;
+    number_set_init(&seed, n);
+    if (!g_settings.no_seed && construct_incumbent(n, &seed) &&
+        (incumbent->size == 0 || number_set_max(&seed) < number_set_max(incumbent))) {
+        number_set_copy(incumbent, &seed);
+        LOG_INFO("N=%u: начальное решение Конвея - Гая, max=%" PRIu64,
+                 n, number_set_max(&seed));
+    }
+    if (g_db_manager && n > 1) {
+        seed_from_smaller(n, incumbent);
+    }
+    number_set_clear(&seed);
+}
+
+/**
+ * Общие границы N для последовательного решателя
+ */
+static void attach_board(BacktrackSolver *solver, _Atomic value_t *upper,
+                         const _Atomic value_t *lower) {
+    backtrack_solver_set_shared_bound(solver, upper);
+    backtrack_solver_set_lower_bound(solver, lower);
+    backtrack_solver_set_solution_callback(solver, publish_bound, NULL);
+}
+
+/**
+ * Тип менеджера для N: заданный явно или dset для N < 25, mitm до N = 40,
+ * иначе iterative
+ */
+static ManagerType select_manager_type(uint32_t n) {
+    if (g_settings.manager_forced) {
+        return g_settings.manager_type;
+    }
+    return n < 25 ? MANAGER_TYPE_DSET :
+           n <= 40 ? MANAGER_TYPE_MITM : MANAGER_TYPE_ITERATIVE;
+}
+
 static void* worker_thread(void *arg) {
     Worker *worker = (Worker *)arg;
     WorkerTask *task = &worker->task;
@@ -80,61 +449,182 @@ static void* worker_thread(void *arg) {
     // Проверяем, решено ли уже
     if (g_db_manager && db_manager_has_optimal_solution(g_db_manager, task->n)) {
         LOG_INFO("N=%u уже решено, пропускаем", task->n);
+        if (g_bound_board && db_manager_get_result(g_db_manager, task->n, &worker->result)) {
+            settle_with_board(task->n, &worker->result);
+        }
         worker->result.n = task->n;
         worker->result.status = SOLUTION_STATUS_OPTIMAL;
         worker->completed = true;
         return NULL;
     }
 
-    // Выбираем тип менеджера
-    ManagerType manager_type = task->n < 25 ? MANAGER_TYPE_FAST : MANAGER_TYPE_ITERATIVE;
-
     // Создаем конфиг
     SolverConfig config = {
         .n = task->n,
         .find_all_optimal = task->find_all_optimal,
         .first_only = task->first_only,
-        .manager_type = manager_type,
+        .manager_type = select_manager_type(task->n),
         .log_interval_sec = ERDOS_LOG_INTERVAL_SEC,
         .stop_flag = task->stop_flag,
-        .initial_bound = 0
+        .initial_bound = 0,
+        .disabled_bounds = BOUND_RULES_ALL & ~g_settings.bounds,
+        .order = g_settings.order,
+        .nogood_cache_mb = g_settings.nogood_cache_mb,
+        .time_limit_sec = g_settings.time_limit_sec,
+        .node_limit = g_settings.node_limit
     };
 
-    // Пробуем получить границу из БД
-    if (g_db_manager) {
-        value_t bound;
-        if (db_manager_get_best_bound(g_db_manager, task->n, &bound)) {
-            config.initial_bound = bound;
-            LOG_INFO("N=%u: используем границу из БД", task->n);
-        }
+    // Параллельный поиск и распознавание строят множество снизу вверх
+    if ((g_settings.decision || g_settings.local_search || g_settings.threads != 1) &&
+        config.order != SEARCH_ORDER_ASCENDING) {
+        LOG_WARNING("N=%u: порядок %s только для последовательного поиска, используется ascending",
+                    task->n, search_order_to_string(config.order));
+        config.order = SEARCH_ORDER_ASCENDING;
     }
 
-    // Создаем и запускаем решатель
-    BacktrackSolver *solver = backtrack_solver_create(&config);
+    NumberSet incumbent;
+    number_set_init(&incumbent, task->n);
+    build_incumbent(task->n, &incumbent);
+
+    // Доска границ: решение другого N могло уже дать лучшее множество,
+    // свое начальное решение дает границы меньшим N; оптимум N-1 из БД -
+    // нижняя граница
+    _Atomic value_t *board_upper = bound_board_upper(g_bound_board, task->n);
+    const _Atomic value_t *board_lower = bound_board_lower(g_bound_board, task->n);
+    if (board_upper) {
+        NumberSet shared;
+        number_set_init(&shared, task->n);
+        if (bound_board_get(g_bound_board, task->n, &shared) &&
+            (incumbent.size == 0 || number_set_max(&shared) < number_set_max(&incumbent))) {
+            number_set_copy(&incumbent, &shared);
+            LOG_INFO("N=%u: начальное решение с доски границ, max=%" PRIu64,
+                     task->n, number_set_max(&shared));
+        }
+        number_set_clear(&shared);
+        if (incumbent.size > 0) {
+            bound_board_publish(g_bound_board, &incumbent);
+        }
 
-    if (task->find_all_optimal) {
-        backtrack_solver_solve_all(solver, &worker->result);
-    } else {
-        backtrack_solver_solve(solver, &worker->result);
+        SolutionResult previous;
+        solution_result_init(&previous);
+        if (g_db_manager && task->n > 1 &&
+            db_manager_get_result(g_db_manager, task->n - 1, &previous) &&
+            previous.status == SOLUTION_STATUS_OPTIMAL) {
+            bound_board_set_optimal(g_bound_board, task->n - 1, previous.max_value);
+        }
+        solution_result_clear(&previous);
+    }
+
+    if (incumbent.size > 0) {
+        config.initial_bound = number_set_max(&incumbent) + 1;
     }
 
-    // Сохраняем результат в БД
-    if (g_db_manager && worker->result.status == SOLUTION_STATUS_OPTIMAL) {
-        pthread_mutex_lock(&g_result_mutex);
-        db_manager_save_result(g_db_manager, &worker->result);
+    NumberSet *optimal_sets = NULL;
+    size_t optimal_count = 0;
+
+    // Все оптимальные с БД: множества пишутся в фоне по мере нахождения
+    OptimalWriter *writer = task->find_all_optimal && g_db_manager && !g_settings.local_search ?
+                            optimal_writer_create(g_db_manager, task->n, 0) : NULL;
+
+    if (g_settings.local_search) {
+        // Верхняя граница без доказательства: проверенные улучшения пишутся
+        // в БД по мере нахождения, итог поиска отдельно не сохраняется
+        LocalSearch *search = local_search_create(&config, g_settings.threads);
+        if (incumbent.size > 0) {
+            local_search_set_incumbent(search, &incumbent);
+        }
+        local_search_set_improvement_callback(search, save_improvement, NULL);
+        local_search_solve(search, &worker->result);
+        local_search_destroy(search);
+    } else if (g_settings.decision) {
+        // Распознавание: M по возрастанию, -t - сколько M проверяется сразу
+        DecisionSolver *decision = decision_solver_create(&config, g_settings.threads);
+        if (incumbent.size > 0) {
+            decision_solver_set_incumbent(decision, &incumbent);
+        }
+        if (writer) {
+            decision_solver_set_optimal_callback(decision, stream_optimal_set, writer);
+        }
+
+        // Нижняя граница из БД: f(n) > f(n-1)
+        SolutionResult previous;
+        solution_result_init(&previous);
+        if (g_db_manager && task->n > 1 &&
+            db_manager_get_result(g_db_manager, task->n - 1, &previous) &&
+            previous.status == SOLUTION_STATUS_OPTIMAL) {
+            decision_solver_set_lower_bound(decision, previous.max_value + 1);
+        }
+        solution_result_clear(&previous);
+        if (board_lower && atomic_load(board_lower) > 0) {
+            decision_solver_set_lower_bound(decision, atomic_load(board_lower));
+        }
 
-        // Сохраняем все оптимальные решения если нужно
-        if (task->find_all_optimal) {
-            NumberSet *optimal_sets;
-            size_t count = backtrack_solver_get_optimal_solutions(solver, &optimal_sets);
-            if (count > 0) {
-                db_manager_save_optimal_sets(g_db_manager, task->n, optimal_sets, count);
+        decision_solver_solve(decision, &worker->result);
+        optimal_count = decision_solver_get_optimal_solutions(decision, &optimal_sets);
+        save_worker_result(task, &worker->result, writer, optimal_sets, optimal_count);
+        decision_solver_destroy(decision);
+    } else if (g_settings.threads != 1) {
+        // Параллельный поиск внутри одного N
+        ParallelSolver *parallel = parallel_solver_create(&config, g_settings.threads,
+                                                          g_settings.split_depth);
+        if (incumbent.size > 0) {
+            parallel_solver_set_incumbent(parallel, &incumbent);
+        }
+        if (writer) {
+            parallel_solver_set_optimal_callback(parallel, stream_optimal_set, writer);
+        }
+        if (board_upper) {
+            parallel_solver_set_external_bounds(parallel, board_upper, board_lower);
+            parallel_solver_set_solution_callback(parallel, publish_bound, NULL);
+        }
+        parallel_solver_solve(parallel, &worker->result);
+        optimal_count = parallel_solver_get_optimal_solutions(parallel, &optimal_sets);
+        save_worker_result(task, &worker->result, writer, optimal_sets, optimal_count);
+        parallel_solver_destroy(parallel);
+    } else if (config.order == SEARCH_ORDER_AUTO) {
+        // Оба порядка построения поочередно
+        BacktrackSolver *solvers[2];
+        const SearchOrder orders[2] = { SEARCH_ORDER_ASCENDING, SEARCH_ORDER_DESCENDING };
+        for (int i = 0; i < 2; i++) {
+            SolverConfig order_config = config;
+            order_config.order = orders[i];
+            solvers[i] = backtrack_solver_create(&order_config);
+            if (incumbent.size > 0) {
+                backtrack_solver_set_incumbent(solvers[i], &incumbent);
+            }
+            if (writer) {
+                backtrack_solver_set_optimal_callback(solvers[i], stream_optimal_set, writer);
+            }
+            if (board_upper) {
+                attach_board(solvers[i], board_upper, board_lower);
             }
         }
-        pthread_mutex_unlock(&g_result_mutex);
-    }
 
-    backtrack_solver_destroy(solver);
+        BacktrackSolver *winner = solve_race(task, solvers, &worker->result);
+        optimal_count = backtrack_solver_get_optimal_solutions(winner, &optimal_sets);
+        save_worker_result(task, &worker->result, writer, optimal_sets, optimal_count);
+        backtrack_solver_destroy(solvers[0]);
+        backtrack_solver_destroy(solvers[1]);
+    } else {
+        // Создаем и запускаем решатель
+        BacktrackSolver *solver = backtrack_solver_create(&config);
+        if (incumbent.size > 0) {
+            backtrack_solver_set_incumbent(solver, &incumbent);
+        }
+        if (writer) {
+            backtrack_solver_set_optimal_callback(solver, stream_optimal_set, writer);
+        }
+        if (board_upper) {
+            attach_board(solver, board_upper, board_lower);
+        }
+        solve_with_checkpoints(task, solver, &worker->result);
+
+        optimal_count = backtrack_solver_get_optimal_solutions(solver, &optimal_sets);
+        save_worker_result(task, &worker->result, writer, optimal_sets, optimal_count);
+        backtrack_solver_destroy(solver);
+    }
+    optimal_writer_destroy(writer);
+    number_set_clear(&incumbent);
 
     worker->completed = true;
     return NULL;
@@ -171,6 +661,7 @@ static void run_range(uint32_t start_n, uint32_t max_n, uint32_t num_workers,
              start_n, max_n, num_workers);
 
     g_db_manager = db_manager_create(db_path);
+    g_bound_board = bound_board_create();
 
     // Определяем начальный N
     uint32_t last_n = db_manager_get_last_n(g_db_manager);
@@ -230,6 +721,97 @@ static void run_range(uint32_t start_n, uint32_t max_n, uint32_t num_workers,
     }
 
     free(workers);
+    bound_board_destroy(g_bound_board);
+    g_bound_board = NULL;
+    db_manager_destroy(g_db_manager);
+    g_db_manager = NULL;
+
+    if (g_stop_flag) {
+        LOG_WARNING("Вычисления прерваны пользователем");
+    } else {
+        LOG_INFO("Все вычисления завершены");
+    }
+}
+
+/**
+ * Совместный поиск диапазона N одним обходом дерева (--joint)
+ * Последовательный, без контрольных точек: решенные N пропускаются,
+ * начальные решения всех N дают границы целей.
+ */
+static void run_joint(uint32_t start_n, uint32_t max_n, bool find_all, bool first_only,
+                      const char *db_path) {
+    g_db_manager = db_manager_create(db_path);
+
+    if (start_n == 0) {
+        uint32_t last_n = db_manager_get_last_n(g_db_manager);
+        start_n = last_n > 0 ? last_n + 1 : 1;
+    }
+    if (start_n > max_n) {
+        LOG_INFO("Все N до %u уже решены", max_n);
+        db_manager_destroy(g_db_manager);
+        g_db_manager = NULL;
+        return;
+    }
+    LOG_INFO("Запуск совместного решения: N=%u..%u", start_n, max_n);
+
+    if (g_settings.threads != 1 || g_settings.decision || g_settings.local_search ||
+        g_settings.order != SEARCH_ORDER_ASCENDING) {
+        LOG_WARNING("Совместный поиск последовательный, снизу вверх: -t, --decision, "
+                    "--local-search и --order игнорируются");
+    }
+
+    SolverConfig config = {
+        .n = max_n,
+        .find_all_optimal = find_all,
+        .first_only = first_only,
+        .manager_type = select_manager_type(max_n),
+        .log_interval_sec = ERDOS_LOG_INTERVAL_SEC,
+        .stop_flag = &g_stop_flag,
+        .initial_bound = 0,
+        .disabled_bounds = BOUND_RULES_ALL & ~g_settings.bounds,
+        .order = SEARCH_ORDER_ASCENDING,
+        .time_limit_sec = g_settings.time_limit_sec,
+        .node_limit = g_settings.node_limit
+    };
+    JointSolver *solver = joint_solver_create(&config, start_n);
+
+    // Начальные решения по возрастанию N: seed_from_smaller продолжает
+    // множества N-1 из БД
+    uint32_t count = max_n - start_n + 1;
+    bool *solved = calloc(count, sizeof(bool));
+    NumberSet incumbent;
+    number_set_init(&incumbent, max_n);
+    for (uint32_t n = start_n; n <= max_n; n++) {
+        if (db_manager_has_optimal_solution(g_db_manager, n)) {
+            LOG_INFO("N=%u уже решено, пропускаем", n);
+            solved[n - start_n] = true;
+            joint_solver_skip(solver, n);
+            continue;
+        }
+        build_incumbent(n, &incumbent);
+        if (incumbent.size == n) {
+            joint_solver_set_incumbent(solver, &incumbent);
+        }
+    }
+    number_set_clear(&incumbent);
+
+    SolutionResult *results = malloc(count * sizeof(SolutionResult));
+    for (uint32_t i = 0; i < count; i++) {
+        solution_result_init(&results[i]);
+    }
+    joint_solver_solve(solver, results);
+
+    // Незавершенный обход тоже сохраняет лучшие множества
+    for (uint32_t i = 0; i < count; i++) {
+        if (!solved[i] && results[i].solution_set.size > 0) {
+            db_manager_save_result(g_db_manager, &results[i]);
+        }
+        solution_result_clear(&results[i]);
+    }
+    free(results);
+    free(solved);
+    joint_solver_destroy(solver);
+
     db_manager_destroy(g_db_manager);
     g_db_manager = NULL;
 
@@ -252,9 +834,36 @@ static void print_usage(const char *prog_name) {
     printf("  -s, --start-n N      Начать с N (по умолчанию: продолжить)\n");
     printf("  -m, --max-n N        Максимальное N (по умолчанию: без ограничений)\n");
     printf("  -w, --workers N      Количество параллельных воркеров (по умолчанию: 1)\n");
+    printf("  -t, --threads N      Потоков на одно N, 0 = все ядра (по умолчанию: 1)\n");
+    printf("  --split-depth D      Длина префикса задачи параллельного поиска\n");
+    printf("                       (по умолчанию: %d)\n", PARALLEL_DEFAULT_SPLIT_DEPTH);
+    printf("  --checkpoint-interval SEC\n");
+    printf("                       Период контрольных точек поиска, 0 = выключены\n");
+    printf("                       (по умолчанию: %d)\n", ERDOS_CHECKPOINT_INTERVAL_SEC);
     printf("  -d, --db PATH        Путь к базе данных (по умолчанию: %s)\n", ERDOS_DEFAULT_DB_PATH);
     printf("  -a, --all            Искать все оптимальные решения\n");
     printf("  -f, --first-only     Остановиться на первом решении\n");
+    printf("  --manager TYPE       Менеджер сумм: fast, iterative, bitset, sorted, dset, mitm\n");
+    printf("                       (по умолчанию: dset для N < 25, mitm до N = 40,\n");
+    printf("                       иначе iterative)\n");
+    printf("  --bounds LIST        Правила отсечения через запятую: counting, variance,\n");
+    printf("                       all, none\n");
+    printf("                       (по умолчанию: all)\n");
+    printf("  --no-seed            Не использовать конструкцию Конвея - Гая как начальное\n");
+    printf("                       решение\n");
+    printf("  --order ORDER        Порядок построения: ascending, descending, auto\n");
+    printf("                       (оба поочередно; по умолчанию: ascending)\n");
+    printf("  --nogood-cache MB    Кеш тупиковых состояний поиска, 0 = выключен\n");
+    printf("                       (по умолчанию: 0)\n");
+    printf("  --decision           Распознавание: проверять max = L, L+1, ... от нижней\n");
+    printf("                       границы, -t - сколько значений проверяется сразу\n");
+    printf("  --local-search       Локальный поиск верхней границы (имитация отжига)\n");
+    printf("                       вместо перебора, проверенные улучшения - FEASIBLE\n");
+    printf("  --joint              Решить диапазон -s..-m одним обходом дерева: узел\n");
+    printf("                       отсекается, только если не улучшает ни одно N\n");
+    printf("  --time-limit SEC     Ограничение времени на каждое N: по истечении\n");
+    printf("                       сохраняется лучшее найденное решение (TIMEOUT)\n");
+    printf("  --node-limit NODES   Ограничение узлов на каждое N (auto - на каждый порядок)\n");
     printf("  --show [N]           Показать результаты (для N или все)\n");
     printf("  --stats              Показать статистику БД\n");
     printf("  -v, --verbose        Подробный вывод\n");
@@ -262,6 +871,8 @@ static void print_usage(const char *prog_name) {
     printf("\nПримеры:\n");
     printf("  %s -n 5              # Решить для N=5\n", prog_name);
     printf("  %s -s 1 -m 10 -w 4   # Решить N=1..10 в 4 потока\n", prog_name);
+    printf("  %s -n 9 -t 0         # Решить N=9 на всех ядрах\n", prog_name);
+    printf("  %s -s 1 -m 9 --joint # Решить N=1..9 одним обходом\n", prog_name);
     printf("  %s --show            # Показать все результаты\n", prog_name);
     printf("  %s --show 5          # Показать результат для N=5\n", prog_name);
 }
@@ -275,9 +886,23 @@ typedef struct {
     uint32_t start_n;
     uint32_t max_n;
     uint32_t workers;
+    uint32_t threads;
+    uint32_t split_depth;
+    uint32_t checkpoint_interval;
     char *db_path;
     bool find_all;
     bool first_only;
+    bool manager_forced;
+    ManagerType manager_type;
+    uint32_t bounds;
+    bool no_seed;
+    bool decision;
+    bool local_search;
+    bool joint;
+    SearchOrder order;
+    uint32_t nogood_cache_mb;
+    double time_limit_sec;
+    uint64_t node_limit;
     bool show_results;
     uint32_t show_n;
     bool show_stats;
@@ -291,9 +916,22 @@ static void parse_args(int argc, char *argv[], CliOptions *opts) {
         {"start-n",    required_argument, 0, 's'},
         {"max-n",      required_argument, 0, 'm'},
         {"workers",    required_argument, 0, 'w'},
+        {"threads",    required_argument, 0, 't'},
+        {"split-depth", required_argument, 0, 'D'},
+        {"checkpoint-interval", required_argument, 0, 'C'},
         {"db",         required_argument, 0, 'd'},
         {"all",        no_argument,       0, 'a'},
         {"first-only", no_argument,       0, 'f'},
+        {"manager",    required_argument, 0, 'M'},
+        {"bounds",     required_argument, 0, 'B'},
+        {"no-seed",    no_argument,       0, 'N'},
+        {"decision",   no_argument,       0, 'R'},
+        {"local-search", no_argument,     0, 'H'},
+        {"joint",      no_argument,       0, 'J'},
+        {"order",      required_argument, 0, 'O'},
+        {"nogood-cache", required_argument, 0, 'G'},
+        {"time-limit", required_argument, 0, 'L'},
+        {"node-limit", required_argument, 0, 'K'},
         {"show",       optional_argument, 0, 'S'},
         {"stats",      no_argument,       0, 'T'},
         {"verbose",    no_argument,       0, 'v'},
@@ -304,12 +942,15 @@ static void parse_args(int argc, char *argv[], CliOptions *opts) {
     // Значения по умолчанию
     memset(opts, 0, sizeof(CliOptions));
     opts->workers = 1;
+    opts->threads = 1;
+    opts->checkpoint_interval = ERDOS_CHECKPOINT_INTERVAL_SEC;
+    opts->bounds = BOUND_RULES_ALL;
     opts->max_n = UINT32_MAX;
 
     int opt;
     int option_index = 0;
 
-    while ((opt = getopt_long(argc, argv, "n:s:m:w:d:afvh", long_options, &option_index)) != -1) {
+    while ((opt = getopt_long(argc, argv, "n:s:m:w:t:d:afvh", long_options, &option_index)) != -1) {
         switch (opt) {
             case 'n':
                 opts->n = (uint32_t)atoi(optarg);
@@ -324,6 +965,15 @@ static void parse_args(int argc, char *argv[], CliOptions *opts) {
                 opts->workers = (uint32_t)atoi(optarg);
                 if (opts->workers == 0) opts->workers = 1;
                 break;
+            case 't':
+                opts->threads = (uint32_t)atoi(optarg);
+                break;
+            case 'D':
+                opts->split_depth = (uint32_t)atoi(optarg);
+                break;
+            case 'C':
+                opts->checkpoint_interval = (uint32_t)atoi(optarg);
+                break;
             case 'd':
                 opts->db_path = strdup(optarg);
                 break;
@@ -333,6 +983,44 @@ static void parse_args(int argc, char *argv[], CliOptions *opts) {
             case 'f':
                 opts->first_only = true;
                 break;
+            case 'M':
+                if (manager_type_from_string(optarg, &opts->manager_type)) {
+                    opts->manager_forced = true;
+                } else {
+                    fprintf(stderr, "Неизвестный тип менеджера: %s\n", optarg);
+                }
+                break;
+            case 'B':
+                if (!search_bounds_parse(optarg, &opts->bounds)) {
+                    fprintf(stderr, "Неизвестное правило отсечения: %s\n", optarg);
+                }
+                break;
+            case 'N':
+                opts->no_seed = true;
+                break;
+            case 'R':
+                opts->decision = true;
+                break;
+            case 'H':
+                opts->local_search = true;
+                break;
+            case 'J':
+                opts->joint = true;
+                break;
+            case 'G':
+                opts->nogood_cache_mb = (uint32_t)atoi(optarg);
+                break;
+            case 'L':
+                opts->time_limit_sec = atof(optarg);
+                break;
+            case 'K':
+                opts->node_limit = strtoull(optarg, NULL, 10);
+                break;
+            case 'O':
+                if (!search_order_from_string(optarg, &opts->order)) {
+                    fprintf(stderr, "Неизвестный порядок построения: %s\n", optarg);
+                }
+                break;
             case 'S':
                 opts->show_results = true;
                 if (optarg) {
@@ -417,10 +1105,33 @@ int main(int argc, char *argv[]) {
     // Установка обработчиков сигналов
     setup_signal_handlers();
 
+    // Общие настройки решателя
+    g_settings.manager_forced = opts.manager_forced;
+    g_settings.manager_type = opts.manager_type;
+    g_settings.threads = opts.threads;
+    g_settings.split_depth = opts.split_depth;
+    g_settings.checkpoint_interval = opts.checkpoint_interval;
+    g_settings.bounds = opts.bounds;
+    g_settings.no_seed = opts.no_seed;
+    g_settings.decision = opts.decision;
+    g_settings.local_search = opts.local_search;
+    g_settings.order = opts.order;
+    g_settings.nogood_cache_mb = opts.nogood_cache_mb;
+    g_settings.time_limit_sec = opts.time_limit_sec;
+    g_settings.node_limit = opts.node_limit;
+
     // Запуск вычислений
     if (opts.n > 0) {
         // Решение для конкретного N
         run_single(opts.n, opts.find_all, opts.first_only, opts.db_path);
+    } else if (opts.joint) {
+        // Совместный поиск: диапазон должен быть ограничен
+        if (opts.max_n > JOINT_MAX_N) {
+            fprintf(stderr, "--joint требует -m N не больше %d\n", JOINT_MAX_N);
+            free(opts.db_path);
+            return 1;
+        }
+        run_joint(opts.start_n, opts.max_n, opts.find_all, opts.first_only, opts.db_path);
     } else {
         // Параллельное решение диапазона
         run_range(opts.start_n, opts.max_n, opts.workers,
@@ -0,0 +1,33 @@
+/**
+ * nogood_cache.c - Кеш тупиковых состояний поиска
+ */
+
+#include <stdlib.h>
+#include "../include/nogood_cache.h"
+
+NogoodCache* nogood_cache_create(size_t size_mb) {
+    if (size_mb == 0) {
+        return NULL;
+    }
+
+    // Наибольшая степень двойки записей в пределах размера
+    size_t count = 1;
+    while (count * 2 * sizeof(NogoodEntry) <= size_mb << 20) {
+        count *= 2;
+    }
+
+    NogoodCache *cache = malloc(sizeof(NogoodCache));
+    cache->entries = calloc(count, sizeof(NogoodEntry));
+    if (!cache->entries) {
+        free(cache);
+        return NULL;
+    }
+    cache->mask = count - 1;
+    return cache;
+}
+
+void nogood_cache_destroy(NogoodCache *cache) {
+    if (!cache) return;
+    free(cache->entries);
+    free(cache);
+}
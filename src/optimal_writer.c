@@ -0,0 +1,170 @@
+/**
+ * optimal_writer.c - Фоновая запись оптимальных множеств в БД
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "../include/optimal_writer.h"
+#include "../include/logger.h"
+
+// ============================================================================
+// Фоновый поток
+// ============================================================================
+
+/**
+ * Запись пакета: смена максимума и вставка множеств с текущим максимумом
+ */
+static void write_batch(OptimalWriter *writer, size_t taken) {
+    size_t kept = 0;
+
+    for (size_t i = 0; i < taken; i++) {
+        value_t max_value = number_set_max(&writer->batch[i]);
+
+        if (writer->persisted_max == 0 || max_value < writer->persisted_max) {
+            // Строго лучший максимум: записанные и накопленные множества не оптимальны
+            db_manager_delete_pending_sets_above(writer->db, writer->n, max_value);
+            writer->persisted_max = max_value;
+            writer->persisted_count = 0;
+            kept = 0;
+        } else if (max_value > writer->persisted_max) {
+            // Устаревшее множество (например, от воркера с прежним максимумом)
+            continue;
+        }
+
+        if (kept != i) {
+            NumberSet tmp = writer->batch[kept];
+            writer->batch[kept] = writer->batch[i];
+            writer->batch[i] = tmp;
+        }
+        kept++;
+    }
+
+    if (kept > 0 && db_manager_save_pending_sets(writer->db, writer->n, writer->batch, kept)) {
+        writer->persisted_count += kept;
+    }
+}
+
+static void* writer_main(void *arg) {
+    OptimalWriter *writer = (OptimalWriter *)arg;
+
+    pthread_mutex_lock(&writer->lock);
+    for (;;) {
+        while (writer->count == 0 && !writer->closing) {
+            pthread_cond_wait(&writer->not_empty, &writer->lock);
+        }
+        if (writer->count == 0) break;
+
+        // Забираем очередь целиком обменом буферов, без копирования
+        size_t taken = 0;
+        while (writer->count > 0) {
+            NumberSet tmp = writer->batch[taken];
+            writer->batch[taken] = writer->queue[writer->head];
+            writer->queue[writer->head] = tmp;
+            writer->head = (writer->head + 1) % writer->capacity;
+            writer->count--;
+            taken++;
+        }
+        pthread_cond_broadcast(&writer->not_full);
+        pthread_mutex_unlock(&writer->lock);
+
+        write_batch(writer, taken);
+
+        pthread_mutex_lock(&writer->lock);
+    }
+    pthread_mutex_unlock(&writer->lock);
+
+    return NULL;
+}
+
+// ============================================================================
+// Публичные функции
+// ============================================================================
+
+OptimalWriter* optimal_writer_create(DatabaseManager *db, uint32_t n, size_t capacity) {
+    if (capacity == 0) capacity = OPTIMAL_WRITER_QUEUE_CAPACITY;
+
+    OptimalWriter *writer = malloc(sizeof(OptimalWriter));
+    writer->db = db;
+    writer->n = n;
+
+    writer->queue = malloc(capacity * sizeof(NumberSet));
+    writer->batch = malloc(capacity * sizeof(NumberSet));
+    for (size_t i = 0; i < capacity; i++) {
+        number_set_init(&writer->queue[i], n);
+        number_set_init(&writer->batch[i], n);
+    }
+    writer->capacity = capacity;
+    writer->head = 0;
+    writer->count = 0;
+
+    pthread_mutex_init(&writer->lock, NULL);
+    pthread_cond_init(&writer->not_empty, NULL);
+    pthread_cond_init(&writer->not_full, NULL);
+    writer->closing = false;
+
+    writer->persisted_max = 0;
+    writer->persisted_count = 0;
+    if (db_manager_get_pending_sets_max(db, n, &writer->persisted_max)) {
+        LOG_INFO("N=%u: в БД уже есть предварительные множества с max=%" PRIu64,
+                 n, writer->persisted_max);
+    }
+
+    writer->running = pthread_create(&writer->thread, NULL, writer_main, writer) == 0;
+    if (!writer->running) {
+        LOG_ERROR("N=%u: не удалось запустить поток записи оптимальных множеств", n);
+    }
+
+    return writer;
+}
+
+void optimal_writer_push(OptimalWriter *writer, const NumberSet *set) {
+    pthread_mutex_lock(&writer->lock);
+    while (writer->count == writer->capacity && writer->running && !writer->closing) {
+        pthread_cond_wait(&writer->not_full, &writer->lock);
+    }
+
+    if (writer->running && !writer->closing) {
+        // Слоты выделены на N элементов - копируем без перевыделения
+        NumberSet *slot = &writer->queue[(writer->head + writer->count) % writer->capacity];
+        if (slot->capacity < set->size) {
+            number_set_copy(slot, set);
+        } else {
+            memcpy(slot->elements, set->elements, set->size * sizeof(value_t));
+            slot->size = set->size;
+        }
+        writer->count++;
+        pthread_cond_signal(&writer->not_empty);
+    }
+    pthread_mutex_unlock(&writer->lock);
+}
+
+void optimal_writer_close(OptimalWriter *writer) {
+    pthread_mutex_lock(&writer->lock);
+    bool join = writer->running && !writer->closing;
+    writer->closing = true;
+    pthread_cond_broadcast(&writer->not_empty);
+    pthread_cond_broadcast(&writer->not_full);
+    pthread_mutex_unlock(&writer->lock);
+
+    if (join) {
+        pthread_join(writer->thread, NULL);
+    }
+}
+
+void optimal_writer_destroy(OptimalWriter *writer) {
+    if (!writer) return;
+
+    optimal_writer_close(writer);
+
+    for (size_t i = 0; i < writer->capacity; i++) {
+        number_set_clear(&writer->queue[i]);
+        number_set_clear(&writer->batch[i]);
+    }
+    free(writer->queue);
+    free(writer->batch);
+
+    pthread_cond_destroy(&writer->not_full);
+    pthread_cond_destroy(&writer->not_empty);
+    pthread_mutex_destroy(&writer->lock);
+    free(writer);
+}
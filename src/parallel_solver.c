@@ -0,0 +1,524 @@
+/**
+ * parallel_solver.c - Параллельный поиск с кражей задач
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include "../include/parallel_solver.h"
+#include "../include/logger.h"
+
+// ============================================================================
+// Константы
+// ============================================================================
+
+#define TASK_DEQUE_INITIAL_CAPACITY 64
+#define COORDINATOR_POLL_USEC 100000
+#define IDLE_WAIT_USEC 200
+
+// ============================================================================
+// Дека задач
+// ============================================================================
+
+static void task_deque_init(TaskDeque *deque) {
+    deque->capacity = TASK_DEQUE_INITIAL_CAPACITY;
+    deque->tasks = malloc(deque->capacity * sizeof(ParallelTask));
+    deque->head = 0;
+    deque->count = 0;
+    pthread_mutex_init(&deque->lock, NULL);
+}
+
+static void task_deque_destroy(TaskDeque *deque) {
+    free(deque->tasks);
+    pthread_mutex_destroy(&deque->lock);
+}
+
+/**
+ * Добавление задачи в конец (только владелец)
+ */
+static void task_deque_push(TaskDeque *deque, const ParallelTask *task) {
+    pthread_mutex_lock(&deque->lock);
+
+    if (deque->count == deque->capacity) {
+        // Разворачиваем кольцо в начало нового буфера
+        size_t new_capacity = deque->capacity * 2;
+        ParallelTask *tasks = malloc(new_capacity * sizeof(ParallelTask));
+        for (size_t i = 0; i < deque->count; i++) {
+            tasks[i] = deque->tasks[(deque->head + i) % deque->capacity];
+        }
+        free(deque->tasks);
+        deque->tasks = tasks;
+        deque->head = 0;
+        deque->capacity = new_capacity;
+    }
+
+    deque->tasks[(deque->head + deque->count) % deque->capacity] = *task;
+    deque->count++;
+
+    pthread_mutex_unlock(&deque->lock);
+}
+
+/**
+ * Взятие задачи с конца (владелец, обход в глубину)
+ */
+static bool task_deque_pop(TaskDeque *deque, ParallelTask *task) {
+    bool found = false;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->count > 0) {
+        deque->count--;
+        *task = deque->tasks[(deque->head + deque->count) % deque->capacity];
+        found = true;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+/**
+ * Кража задачи с начала (самый короткий префикс - самое большое поддерево)
+ */
+static bool task_deque_steal(TaskDeque *deque, ParallelTask *task) {
+    bool found = false;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->count > 0) {
+        *task = deque->tasks[deque->head];
+        deque->head = (deque->head + 1) % deque->capacity;
+        deque->count--;
+        found = true;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+// ============================================================================
+// Воркер
+// ============================================================================
+
+/**
+ * Прогресс решателя воркера публикуется для общего отчета
+ */
+static void worker_progress(const SearchStats *stats, void *user_data) {
+    ParallelWorker *worker = (ParallelWorker *)user_data;
+    atomic_store_explicit(&worker->nodes, stats->nodes_explored, memory_order_relaxed);
+}
+
+static void worker_solution(uint32_t n, value_t max_value, const NumberSet *solution,
+                            void *user_data) {
+    ParallelWorker *worker = (ParallelWorker *)user_data;
+    ParallelSolver *parallel = worker->owner;
+    if (parallel->solution_callback) {
+        parallel->solution_callback(n, max_value, solution, parallel->solution_user_data);
+    }
+}
+
+static bool steal_task(ParallelSolver *parallel, uint32_t thief, ParallelTask *task) {
+    for (uint32_t i = 1; i < parallel->thread_count; i++) {
+        uint32_t victim = (thief + i) % parallel->thread_count;
+        if (task_deque_steal(&parallel->workers[victim].deque, task)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Выполнение задачи: спуск по первым потомкам до глубины разбиения,
+ * остатки каждого уровня откладываются в деку, поддерево на глубине
+ * разбиения перебирается последовательно
+ */
+static void run_task(ParallelSolver *parallel, ParallelWorker *worker, ParallelTask task) {
+    BacktrackSolver *solver = worker->solver;
+
+    if (!backtrack_solver_load_prefix(solver, task.prefix, task.depth)) {
+        return;
+    }
+
+    for (;;) {
+        value_t child;
+        if (!backtrack_solver_next_child(solver, task.next, &child)) {
+            return;
+        }
+
+        // Остальные потомки - отдельная задача, ее могут украсть
+        ParallelTask rest = task;
+        rest.next = child + 1;
+        atomic_fetch_add_explicit(&parallel->pending, 1, memory_order_relaxed);
+        task_deque_push(&worker->deque, &rest);
+
+        task.prefix[task.depth++] = child;
+        task.next = child + 1;
+        if (task.depth < parallel->split_depth) {
+            continue;
+        }
+
+        backtrack_solver_search_subtree(solver);
+        atomic_store_explicit(&worker->nodes, solver->stats.nodes_explored,
+                              memory_order_relaxed);
+
+        if (parallel->config.first_only && solver->stats.solutions_found > 0) {
+            parallel->stop = true;
+        }
+        return;
+    }
+}
+
+static void* worker_main(void *arg) {
+    ParallelWorker *worker = (ParallelWorker *)arg;
+    ParallelSolver *parallel = worker->owner;
+    ParallelTask task;
+
+    while (!parallel->stop) {
+        if (task_deque_pop(&worker->deque, &task) ||
+            steal_task(parallel, worker->index, &task)) {
+            run_task(parallel, worker, task);
+            atomic_fetch_sub_explicit(&parallel->pending, 1, memory_order_acq_rel);
+        } else if (atomic_load_explicit(&parallel->pending, memory_order_acquire) == 0) {
+            break;
+        } else {
+            // Задачи есть только в работе у других - ждем, пока появятся остатки
+            usleep(IDLE_WAIT_USEC);
+        }
+    }
+
+    atomic_fetch_sub_explicit(&parallel->running, 1, memory_order_release);
+    return NULL;
+}
+
+// ============================================================================
+// Создание и уничтожение
+// ============================================================================
+
+ParallelSolver* parallel_solver_create(const SolverConfig *config,
+                                       uint32_t thread_count,
+                                       uint32_t split_depth) {
+    ParallelSolver *parallel = malloc(sizeof(ParallelSolver));
+    parallel->config = *config;
+
+    if (thread_count == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = cpus > 0 ? (uint32_t)cpus : 1;
+    }
+    parallel->thread_count = thread_count;
+
+    // Префикс поддерева - от 1 до N элементов
+    if (split_depth == 0) split_depth = PARALLEL_DEFAULT_SPLIT_DEPTH;
+    if (split_depth > PARALLEL_MAX_SPLIT_DEPTH) split_depth = PARALLEL_MAX_SPLIT_DEPTH;
+    if (split_depth > config->n) split_depth = config->n;
+    if (split_depth == 0) split_depth = 1;
+    parallel->split_depth = split_depth;
+
+    // Решатели воркеров останавливаются общим флагом, прогресс
+    // публикуют через callback - отчет печатает координатор
+    SolverConfig worker_config = *config;
+    worker_config.stop_flag = &parallel->stop;
+    worker_config.log_interval_sec = 1;
+    worker_config.time_limit_sec = 0;  // Ограничения запуска - общие, у координатора
+    worker_config.node_limit = 0;
+
+    // Кеш тупиков один на всех: тупик одного воркера отсекает узлы остальных
+    parallel->nogood_cache = nogood_cache_create(config->nogood_cache_mb);
+    worker_config.nogood_cache_mb = 0;
+
+    parallel->workers = calloc(thread_count, sizeof(ParallelWorker));
+    for (uint32_t i = 0; i < thread_count; i++) {
+        ParallelWorker *worker = &parallel->workers[i];
+        worker->owner = parallel;
+        worker->index = i;
+        worker->solver = backtrack_solver_create(&worker_config);
+        backtrack_solver_set_shared_bound(worker->solver, &parallel->best_max);
+        if (parallel->nogood_cache) {
+            backtrack_solver_set_nogood_cache(worker->solver, parallel->nogood_cache);
+        }
+        backtrack_solver_set_progress_callback(worker->solver, worker_progress, worker);
+        backtrack_solver_set_solution_callback(worker->solver, worker_solution, worker);
+        task_deque_init(&worker->deque);
+    }
+
+    parallel->all_optimal_solutions = NULL;
+    parallel->optimal_count = 0;
+    parallel->optimal_streamed = 0;
+
+    parallel->external_upper = NULL;
+    parallel->external_lower = NULL;
+    parallel->solution_callback = NULL;
+    parallel->solution_user_data = NULL;
+
+    return parallel;
+}
+
+void parallel_solver_destroy(ParallelSolver *parallel) {
+    if (!parallel) return;
+
+    for (uint32_t i = 0; i < parallel->thread_count; i++) {
+        backtrack_solver_destroy(parallel->workers[i].solver);
+        task_deque_destroy(&parallel->workers[i].deque);
+    }
+    free(parallel->workers);
+    nogood_cache_destroy(parallel->nogood_cache);
+
+    if (parallel->all_optimal_solutions) {
+        for (size_t i = 0; i < parallel->optimal_count; i++) {
+            number_set_clear(&parallel->all_optimal_solutions[i]);
+        }
+        free(parallel->all_optimal_solutions);
+    }
+
+    free(parallel);
+}
+
+void parallel_solver_set_incumbent(ParallelSolver *parallel, const NumberSet *set) {
+    for (uint32_t i = 0; i < parallel->thread_count; i++) {
+        backtrack_solver_set_incumbent(parallel->workers[i].solver, set);
+    }
+}
+
+void parallel_solver_set_optimal_callback(ParallelSolver *parallel,
+                                          OptimalSetCallback callback,
+                                          void *user_data) {
+    for (uint32_t i = 0; i < parallel->thread_count; i++) {
+        backtrack_solver_set_optimal_callback(parallel->workers[i].solver, callback, user_data);
+    }
+}
+
+void parallel_solver_set_external_bounds(ParallelSolver *parallel,
+                                         _Atomic value_t *upper,
+                                         const _Atomic value_t *lower) {
+    parallel->external_upper = upper;
+    parallel->external_lower = lower;
+}
+
+void parallel_solver_set_solution_callback(ParallelSolver *parallel,
+                                           SolutionCallback callback,
+                                           void *user_data) {
+    parallel->solution_callback = callback;
+    parallel->solution_user_data = user_data;
+}
+
+// ============================================================================
+// Сбор результата
+// ============================================================================
+
+static uint64_t total_nodes(const ParallelSolver *parallel) {
+    uint64_t nodes = 0;
+    for (uint32_t i = 0; i < parallel->thread_count; i++) {
+        nodes += atomic_load_explicit(&parallel->workers[i].nodes, memory_order_relaxed);
+    }
+    return nodes;
+}
+
+/**
+ * Атомарный минимум (0 = максимума нет)
+ */
+static void store_min(_Atomic value_t *bound, value_t value) {
+    value_t current = atomic_load_explicit(bound, memory_order_relaxed);
+    while ((current == 0 || value < current) &&
+           !atomic_compare_exchange_weak_explicit(bound, &current, value,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+}
+
+/**
+ * Обмен с внешними границами: меньший из общего и внешнего максимумов
+ * записывается в оба. Возвращает true, если лучший максимум достиг
+ * доказанной нижней границы - найденное решение оптимально.
+ */
+static bool sync_external_bounds(ParallelSolver *parallel) {
+    if (parallel->external_upper) {
+        value_t external = atomic_load_explicit(parallel->external_upper, memory_order_relaxed);
+        if (external != 0) {
+            store_min(&parallel->best_max, external);
+        }
+        value_t best = atomic_load_explicit(&parallel->best_max, memory_order_relaxed);
+        if (best != 0) {
+            store_min(parallel->external_upper, best);
+        }
+    }
+
+    if (!parallel->external_lower || parallel->config.find_all_optimal) {
+        return false;
+    }
+    value_t lower = atomic_load_explicit(parallel->external_lower, memory_order_relaxed);
+    value_t best = atomic_load_explicit(&parallel->best_max, memory_order_relaxed);
+    return lower != 0 && best != 0 && best <= lower;
+}
+
+/**
+ * Оптимальные множества всех воркеров с итоговым максимумом
+ */
+static void collect_optimal_solutions(ParallelSolver *parallel, value_t best_max) {
+    size_t count = 0;
+    for (uint32_t i = 0; i < parallel->thread_count; i++) {
+        BacktrackSolver *solver = parallel->workers[i].solver;
+        if (solver->has_solution && solver->best_max == best_max) {
+            count += solver->optimal_count;
+            parallel->optimal_streamed += solver->optimal_streamed;
+        }
+    }
+    if (count == 0) return;
+
+    parallel->all_optimal_solutions = malloc(count * sizeof(NumberSet));
+    for (uint32_t i = 0; i < parallel->thread_count; i++) {
+        BacktrackSolver *solver = parallel->workers[i].solver;
+        if (!solver->has_solution || solver->best_max != best_max) continue;
+
+        for (size_t j = 0; j < solver->optimal_count; j++) {
+            NumberSet *dest = &parallel->all_optimal_solutions[parallel->optimal_count++];
+            number_set_init(dest, parallel->config.n);
+            number_set_copy(dest, &solver->all_optimal_solutions[j]);
+        }
+    }
+}
+
+// ============================================================================
+// Решение
+// ============================================================================
+
+void parallel_solver_solve(ParallelSolver *parallel, SolutionResult *result) {
+    uint32_t n = parallel->config.n;
+
+    atomic_store(&parallel->best_max, 0);
+    atomic_store(&parallel->pending, 1);
+    atomic_store(&parallel->running, parallel->thread_count);
+    parallel->stop = false;
+
+    for (uint32_t i = 0; i < parallel->thread_count; i++) {
+        backtrack_solver_prepare(parallel->workers[i].solver);
+        atomic_store(&parallel->workers[i].nodes, 0);
+    }
+
+    // Инкумбент воркеров сразу задает общую границу
+    const BacktrackSolver *first = parallel->workers[0].solver;
+    if (first->has_solution) {
+        atomic_store(&parallel->best_max, first->best_max);
+    }
+    bool lower_stop = sync_external_bounds(parallel);
+
+    if (lower_stop || (parallel->config.first_only && first->has_solution)) {
+        // Первое решение уже есть или уже оптимально - перебор не нужен
+        parallel->stop = true;
+        LOG_INFO("N=%u: используется начальное решение, max=%" PRIu64,
+                 n, atomic_load(&parallel->best_max));
+    } else {
+        // Корневая задача: все потомки пустого префикса
+        ParallelTask root = { .depth = 0, .next = 1 };
+        task_deque_push(&parallel->workers[0].deque, &root);
+    }
+
+    value_t initial_bound = parallel->workers[0].solver->config.initial_bound;
+    log_start(n, initial_bound);
+    LOG_INFO("N=%u: потоков=%u, глубина разбиения=%u",
+             n, parallel->thread_count, parallel->split_depth);
+
+    double start_time = get_time_sec();
+    time_t last_log = time(NULL);
+
+    for (uint32_t i = 0; i < parallel->thread_count; i++) {
+        pthread_create(&parallel->workers[i].thread, NULL, worker_main, &parallel->workers[i]);
+    }
+
+    // Координатор: передает внешнюю остановку, следит за ограничениями
+    // запуска и печатает общий прогресс
+    bool interrupted = false;
+    bool budget_stop = false;
+    while (atomic_load_explicit(&parallel->running, memory_order_acquire) > 0) {
+        usleep(COORDINATOR_POLL_USEC);
+
+        if (parallel->config.stop_flag && *parallel->config.stop_flag) {
+            interrupted = true;
+            parallel->stop = true;
+        }
+        if (!parallel->stop &&
+            solver_config_budget_exhausted(&parallel->config, get_time_sec() - start_time,
+                                           total_nodes(parallel))) {
+            budget_stop = true;
+            parallel->stop = true;
+        }
+        if (!parallel->stop && sync_external_bounds(parallel)) {
+            lower_stop = true;
+            parallel->stop = true;
+        }
+
+        time_t now = time(NULL);
+        if (now - last_log >= parallel->config.log_interval_sec) {
+            last_log = now;
+            value_t best = atomic_load_explicit(&parallel->best_max, memory_order_relaxed);
+            log_progress(n, total_nodes(parallel), get_time_sec() - start_time,
+                         parallel->split_depth, best != 0 ? best : initial_bound);
+        }
+    }
+
+    for (uint32_t i = 0; i < parallel->thread_count; i++) {
+        pthread_join(parallel->workers[i].thread, NULL);
+    }
+
+    double elapsed = get_time_sec() - start_time;
+
+    // Остановка без внешнего флага и ограничений - first_only на первом решении
+    sync_external_bounds(parallel);
+    bool first_only_stop = parallel->stop && !interrupted && !budget_stop && !lower_stop;
+
+    // Лучшее решение среди воркеров
+    const BacktrackSolver *best_solver = NULL;
+    for (uint32_t i = 0; i < parallel->thread_count; i++) {
+        const BacktrackSolver *solver = parallel->workers[i].solver;
+        if (solver->has_solution &&
+            (!best_solver || solver->best_max < best_solver->best_max)) {
+            best_solver = solver;
+        }
+    }
+
+    result->n = n;
+    if (best_solver) {
+        result->max_value = best_solver->best_max;
+        number_set_copy(&result->solution_set, &best_solver->best_solution);
+        result->status = interrupted ? SOLUTION_STATUS_INTERRUPTED :
+                         budget_stop ? SOLUTION_STATUS_TIMEOUT :
+                         first_only_stop ? SOLUTION_STATUS_FEASIBLE : SOLUTION_STATUS_OPTIMAL;
+        if (parallel->config.find_all_optimal) {
+            collect_optimal_solutions(parallel, best_solver->best_max);
+        }
+    } else {
+        result->max_value = 0;
+        result->solution_set.size = 0;
+        result->status = interrupted ? SOLUTION_STATUS_INTERRUPTED :
+                         budget_stop ? SOLUTION_STATUS_TIMEOUT : SOLUTION_STATUS_NO_SOLUTION;
+    }
+    result->computation_time = elapsed;
+    result->nodes_explored = total_nodes(parallel);
+    result->timestamp = time(NULL);
+
+    log_complete(n, result->status, elapsed, result->nodes_explored, result->max_value);
+
+    // Сводка отсечений всех воркеров (буферы префикса не нужны)
+    SearchBounds bounds = parallel->workers[0].solver->bounds;
+    bounds.prefix_sum = NULL;
+    bounds.prefix_sq = NULL;
+    search_bounds_reset_stats(&bounds);
+    for (uint32_t i = 0; i < parallel->thread_count; i++) {
+        search_bounds_merge_stats(&bounds, &parallel->workers[i].solver->bounds);
+    }
+    search_bounds_log_stats(&bounds);
+
+    if (parallel->nogood_cache) {
+        uint64_t hits = 0, stores = 0;
+        for (uint32_t i = 0; i < parallel->thread_count; i++) {
+            hits += parallel->workers[i].solver->nogood_hits;
+            stores += parallel->workers[i].solver->nogood_stores;
+        }
+        LOG_INFO("Кеш тупиков N=%u: %llu отсечений, %llu записей", n,
+                 (unsigned long long)hits, (unsigned long long)stores);
+    }
+
+    if (parallel->config.find_all_optimal) {
+        LOG_INFO("Найдено %zu оптимальных решений для N=%u",
+                 parallel->optimal_count + parallel->optimal_streamed, n);
+    }
+}
+
+size_t parallel_solver_get_optimal_solutions(const ParallelSolver *parallel,
+                                             NumberSet **solutions) {
+    *solutions = parallel->all_optimal_solutions;
+    return parallel->optimal_count;
+}
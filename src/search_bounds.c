@@ -0,0 +1,319 @@
+/**
+ * search_bounds.c - Отсечения по необходимым условиям на префикс
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "../include/search_bounds.h"
+#include "../include/logger.h"
+
+// ============================================================================
+// Правила
+// ============================================================================
+
+/**
+ * Правило: true - префикс длины depth может быть дополнен до решения
+ * с элементами не больше max_value
+ */
+typedef bool (*BoundRuleFn)(const SearchBounds *bounds, uint32_t depth, value_t max_value);
+
+/**
+ * Наибольшая сумма первых j из remaining оставшихся элементов:
+ * элемент позиции depth + i не больше max_value - (remaining - i)
+ */
+static inline value_t max_completion_sum(value_t max_value, uint32_t remaining, uint32_t j) {
+    return (value_t)j * (max_value - remaining) + (value_t)j * (j + 1) / 2;
+}
+
+/**
+ * Счетная граница: k элементов с различными суммами дают 2^k различных
+ * сумм в [0, сумма элементов], поэтому сумма >= 2^k - 1. Это верно для
+ * каждого начального отрезка решения длины depth + j. Запас
+ * S + max_completion_sum(j) - (2^(depth+j) - 1) вогнут по j (вторая
+ * разность 1 - 2^(depth+j) <= 0), поэтому минимум - на концах j = 1
+ * и j = remaining.
+ */
+static bool counting_rule(const SearchBounds *bounds, uint32_t depth, value_t max_value) {
+    uint32_t remaining = bounds->n - depth;
+    if (remaining == 0) {
+        return true;
+    }
+    // Оставшиеся элементы различны и положительны
+    if (max_value < remaining) {
+        return false;
+    }
+
+    value_t sum = bounds->prefix_sum[depth];
+    uint32_t ends[2] = { 1, remaining };
+    for (uint32_t e = 0; e < 2; e++) {
+        uint32_t k = depth + ends[e];
+        if (k < 64 &&
+            sum + max_completion_sum(max_value, remaining, ends[e]) < (1ULL << k) - 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Дисперсионная граница (Эрдёш - Мозер, Элкис): суммы ±a_i/2 по всем
+ * 2^k знакам - 2^k различных чисел с шагом не меньше 1, их дисперсия
+ * Σa_i²/4 не меньше дисперсии 0..2^k - 1, откуда Σa_i² >= (4^k - 1) / 3.
+ * Запас не обязательно вогнут, поэтому проверяются все длины дополнения.
+ */
+static bool variance_rule(const SearchBounds *bounds, uint32_t depth, value_t max_value) {
+    uint32_t remaining = bounds->n - depth;
+    if (remaining == 0 || max_value < remaining) {
+        return remaining == 0;
+    }
+
+    bound_wide_t squares = bounds->prefix_sq[depth];
+    value_t base = max_value - remaining;
+    for (uint32_t i = 1; i <= remaining; i++) {
+        uint32_t k = depth + i;
+        if (k >= 64) {
+            break;
+        }
+        bound_wide_t value = base + i;
+        squares += value * value;
+        if (squares < (((bound_wide_t)1 << (2 * k)) - 1) / 3) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Построение сверху: известны depth наибольших элементов (в prefix_* в
+ * порядке убывания), remaining меньших не больше max_value. Начальные
+ * отрезки решения - сначала j неизвестных (как префикс длины 0 при
+ * построении снизу), затем все неизвестные и i наименьших известных.
+ */
+static bool counting_rule_top(const SearchBounds *bounds, uint32_t depth, value_t max_value) {
+    uint32_t remaining = bounds->n - depth;
+    if (max_value < remaining) {
+        return false;
+    }
+
+    // Одни неизвестные: запас вогнут по j - проверяются концы
+    value_t small = 0;
+    if (remaining > 0) {
+        uint32_t ends[2] = { 1, remaining };
+        for (uint32_t e = 0; e < 2; e++) {
+            uint32_t k = ends[e];
+            if (k < 64 && max_completion_sum(max_value, remaining, k) < (1ULL << k) - 1) {
+                return false;
+            }
+        }
+        small = max_completion_sum(max_value, remaining, remaining);
+    }
+
+    for (uint32_t i = 1; i <= depth; i++) {
+        uint32_t k = remaining + i;
+        if (k >= 64) {
+            break;
+        }
+        value_t sum = small + bounds->prefix_sum[depth] - bounds->prefix_sum[depth - i];
+        if (sum < (1ULL << k) - 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool variance_rule_top(const SearchBounds *bounds, uint32_t depth, value_t max_value) {
+    uint32_t remaining = bounds->n - depth;
+    if (max_value < remaining) {
+        return false;
+    }
+
+    bound_wide_t squares = 0;
+    value_t base = max_value - remaining;
+    for (uint32_t j = 1; j <= remaining; j++) {
+        if (j >= 64) {
+            return true;
+        }
+        bound_wide_t value = base + j;
+        squares += value * value;
+        if (squares < (((bound_wide_t)1 << (2 * j)) - 1) / 3) {
+            return false;
+        }
+    }
+
+    for (uint32_t i = 1; i <= depth; i++) {
+        uint32_t k = remaining + i;
+        if (k >= 64) {
+            break;
+        }
+        bound_wide_t known = bounds->prefix_sq[depth] - bounds->prefix_sq[depth - i];
+        if (squares + known < (((bound_wide_t)1 << (2 * k)) - 1) / 3) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static const struct {
+    const char *name;
+    BoundRuleFn check;             // Построение снизу
+    BoundRuleFn check_top;         // Построение сверху
+} BOUND_RULES[BOUND_RULE_COUNT] = {
+    [BOUND_RULE_COUNTING] = { "counting", counting_rule, counting_rule_top },
+    [BOUND_RULE_VARIANCE] = { "variance", variance_rule, variance_rule_top },
+};
+
+// ============================================================================
+// Состояние
+// ============================================================================
+
+void search_bounds_init(SearchBounds *bounds, uint32_t n, uint32_t enabled) {
+    memset(bounds, 0, sizeof(SearchBounds));
+    bounds->n = n;
+    bounds->enabled = enabled & BOUND_RULES_ALL;
+    bounds->prefix_sum = calloc((size_t)n + 1, sizeof(value_t));
+    bounds->prefix_sq = calloc((size_t)n + 1, sizeof(bound_wide_t));
+}
+
+void search_bounds_destroy(SearchBounds *bounds) {
+    free(bounds->prefix_sum);
+    free(bounds->prefix_sq);
+    bounds->prefix_sum = NULL;
+    bounds->prefix_sq = NULL;
+}
+
+void search_bounds_reset_stats(SearchBounds *bounds) {
+    bounds->checks = 0;
+    memset(bounds->cuts, 0, sizeof(bounds->cuts));
+}
+
+// ============================================================================
+// Проверка
+// ============================================================================
+
+bool search_bounds_feasible(SearchBounds *bounds, uint32_t depth, value_t max_value) {
+    if (bounds->enabled == 0) {
+        return true;
+    }
+
+    bounds->checks++;
+    for (uint32_t rule = 0; rule < BOUND_RULE_COUNT; rule++) {
+        if ((bounds->enabled & (1U << rule)) &&
+            !BOUND_RULES[rule].check(bounds, depth, max_value)) {
+            bounds->cuts[rule]++;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool search_bounds_feasible_top(SearchBounds *bounds, uint32_t depth, value_t max_value) {
+    if (bounds->enabled == 0) {
+        return true;
+    }
+
+    bounds->checks++;
+    for (uint32_t rule = 0; rule < BOUND_RULE_COUNT; rule++) {
+        if ((bounds->enabled & (1U << rule)) &&
+            !BOUND_RULES[rule].check_top(bounds, depth, max_value)) {
+            bounds->cuts[rule]++;
+            return false;
+        }
+    }
+    return true;
+}
+
+value_t search_bounds_lower_bound(SearchBounds *bounds) {
+    uint32_t n = bounds->n;
+    if (n == 0) {
+        return 0;
+    }
+
+    // Степени двойки {1, 2, ..., 2^(n-1)} - решение, граница не выше
+    value_t low = n;
+    value_t high = n <= 63 ? 1ULL << (n - 1) : 1ULL << 62;
+    if (high < low) {
+        high = low;
+    }
+
+    uint64_t checks = bounds->checks;
+    uint64_t cuts[BOUND_RULE_COUNT];
+    memcpy(cuts, bounds->cuts, sizeof(cuts));
+
+    bounds->prefix_sum[0] = 0;
+    bounds->prefix_sq[0] = 0;
+    while (low < high) {
+        value_t middle = low + (high - low) / 2;
+        if (search_bounds_feasible(bounds, 0, middle)) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+
+    bounds->checks = checks;
+    memcpy(bounds->cuts, cuts, sizeof(cuts));
+    return low;
+}
+
+// ============================================================================
+// Настройка и статистика
+// ============================================================================
+
+bool search_bounds_parse(const char *list, uint32_t *enabled) {
+    if (strcmp(list, "all") == 0) {
+        *enabled = BOUND_RULES_ALL;
+        return true;
+    }
+    if (strcmp(list, "none") == 0) {
+        *enabled = 0;
+        return true;
+    }
+
+    uint32_t mask = 0;
+    const char *ptr = list;
+    while (*ptr) {
+        const char *end = strchr(ptr, ',');
+        size_t length = end ? (size_t)(end - ptr) : strlen(ptr);
+
+        bool found = false;
+        for (uint32_t rule = 0; rule < BOUND_RULE_COUNT; rule++) {
+            if (strlen(BOUND_RULES[rule].name) == length &&
+                strncmp(BOUND_RULES[rule].name, ptr, length) == 0) {
+                mask |= 1U << rule;
+                found = true;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+
+        ptr += length;
+        if (*ptr == ',') ptr++;
+    }
+
+    *enabled = mask;
+    return true;
+}
+
+void search_bounds_merge_stats(SearchBounds *total, const SearchBounds *bounds) {
+    total->checks += bounds->checks;
+    for (uint32_t rule = 0; rule < BOUND_RULE_COUNT; rule++) {
+        total->cuts[rule] += bounds->cuts[rule];
+    }
+}
+
+void search_bounds_log_stats(const SearchBounds *bounds) {
+    if (bounds->enabled == 0 || bounds->checks == 0) {
+        return;
+    }
+
+    for (uint32_t rule = 0; rule < BOUND_RULE_COUNT; rule++) {
+        if (bounds->enabled & (1U << rule)) {
+            LOG_INFO("Отсечения N=%u, %s: %llu из %llu префиксов (%.2f%%)",
+                     bounds->n, BOUND_RULES[rule].name,
+                     (unsigned long long)bounds->cuts[rule],
+                     (unsigned long long)bounds->checks,
+                     100.0 * (double)bounds->cuts[rule] / (double)bounds->checks);
+        }
+    }
+}
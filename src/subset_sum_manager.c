@@ -6,6 +6,9 @@
 
 #include <stdlib.h>
 #include <string.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 #include "../include/subset_sum_manager.h"
 #include "../include/logger.h"
 
@@ -14,20 +17,43 @@
 // ============================================================================
 
 #define INITIAL_BUCKET_COUNT 4096
-#define LOAD_FACTOR_THRESHOLD 0.75
-#define POOL_PREALLOC_SIZE 1024
+#define LOAD_FACTOR_THRESHOLD 0.7
+#define GROUP_FULL_MASK ((1u << INT_HASHSET_GROUP) - 1)
+#define BITSET_DEFAULT_LAYERS 64
+#define BITSET_MIN_WORDS 64
+#define BITSET_MAX_LAYER_WORDS (1ULL << 24)
+#define PRESIZE_MAX_ELEMENTS 20
+#define SORTED_DEFAULT_DEPTH 16
+
+// ============================================================================
+// Счетчик аллокаций горячего пути
+// ============================================================================
+
+/**
+ * Число перевыделений памяти в add/remove/next_candidate текущего потока.
+ * Буферы менеджера рассчитываются при создании по (max_elements, max_value),
+ * поэтому в пределах этих границ счетчик не растет. Увеличивается только
+ * при расширении буферов - редкий путь, счетчик не влияет на скорость.
+ */
+static _Thread_local uint64_t hot_allocations = 0;
+
+#define COUNT_HOT_ALLOCATION() (hot_allocations++)
+
+uint64_t subset_sum_manager_hot_allocations(void) {
+    return hot_allocations;
+}
 
 // ============================================================================
 // Быстрая хеш-функция (Murmur3 finalizer)
 // ============================================================================
 
-static inline size_t int_hash(value_t x, size_t bucket_count) {
+static inline size_t int_hash(value_t x, size_t mask) {
     x ^= x >> 33;
     x *= 0xff51afd7ed558ccdULL;
     x ^= x >> 33;
     x *= 0xc4ceb9fe1a85ec53ULL;
     x ^= x >> 33;
-    return (size_t)(x % bucket_count);
+    return (size_t)x & mask;
 }
 
 // ============================================================================
@@ -35,173 +61,259 @@ static inline size_t int_hash(value_t x, size_t bucket_count) {
 // ============================================================================
 
 /**
- * Предаллокация пула узлов
+ * Сравнение группы слотов с value и с пустым ключом
+ * Бит i в *match / *empty соответствует слоту group[i].
  */
-static void int_hashset_prealloc_pool(IntHashSet *set, size_t count) {
-    for (size_t i = 0; i < count; i++) {
-        HashNode *node = malloc(sizeof(HashNode));
-        node->next = set->pool;
-        set->pool = node;
+static inline void group_match(const value_t *group, value_t value,
+                               unsigned *match, unsigned *empty) {
+#ifdef __AVX2__
+    __m256i keys = _mm256_load_si256((const __m256i *)group);
+    __m256i eq = _mm256_cmpeq_epi64(keys, _mm256_set1_epi64x((long long)value));
+    __m256i zero = _mm256_cmpeq_epi64(keys, _mm256_setzero_si256());
+    *match = (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(eq));
+    *empty = (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(zero));
+#else
+    unsigned m = 0;
+    unsigned e = 0;
+    for (unsigned i = 0; i < INT_HASHSET_GROUP; i++) {
+        m |= (unsigned)(group[i] == value) << i;
+        e |= (unsigned)(group[i] == 0) << i;
     }
+    *match = m;
+    *empty = e;
+#endif
+}
+
+/**
+ * Жива ли метка: ее уровень открыт и с тех пор не переоткрывался
+ */
+static inline bool stamp_is_live(const IntHashSet *set, uint64_t stamp) {
+    uint32_t depth = (uint32_t)(stamp & 0xFF);
+    return depth <= set->depth && set->level_stamp[depth] == stamp;
 }
 
 /**
- * Взять узел из пула или создать новый
+ * Поиск слота ненулевого value: первый слот с этим ключом, либо первый
+ * пустой слот в порядке линейного пробирования (туда значение будет
+ * вставлено). Значение вставляется в первый слот со своим ключом или в
+ * пустой, поэтому живой может быть только первый найденный слот с ключом.
  */
-static inline HashNode* pool_get_node(IntHashSet *set) {
-    if (set->pool) {
-        HashNode *node = set->pool;
-        set->pool = node->next;
-        return node;
+static inline size_t int_hashset_find_slot(const IntHashSet *set, value_t value) {
+    size_t home = int_hash(value, set->mask);
+    size_t group = home & ~(size_t)(INT_HASHSET_GROUP - 1);
+    // В первой группе слоты до home не относятся к цепочке пробирования
+    unsigned valid = (GROUP_FULL_MASK << (home - group)) & GROUP_FULL_MASK;
+
+    for (;;) {
+        unsigned match;
+        unsigned empty;
+        group_match(&set->keys[group], value, &match, &empty);
+        match &= valid;
+        empty &= valid;
+
+        // Ключ не может стоять после пустого слота своей цепочки
+        if (match) {
+            return group + (size_t)__builtin_ctz(match);
+        }
+        if (empty) {
+            return group + (size_t)__builtin_ctz(empty);
+        }
+
+        group = (group + INT_HASHSET_GROUP) & set->mask;
+        valid = GROUP_FULL_MASK;
     }
-    return malloc(sizeof(HashNode));
+}
+
+static value_t* int_hashset_alloc_keys(size_t capacity) {
+    // Выравнивание по группе - для выровненной загрузки AVX2
+    size_t bytes = capacity * sizeof(value_t);
+    value_t *keys = aligned_alloc(INT_HASHSET_GROUP * sizeof(value_t), bytes);
+    memset(keys, 0, bytes);
+    return keys;
 }
 
 /**
- * Вернуть узел в пул
+ * Перестроение на месте: мертвые слоты освобождаются, живые значения
+ * переставляются по порядку, начиная за слотом, пустым и до перестроения
+ * (через него не проходит ни одна цепочка). Каждое значение встает не
+ * дальше своего прежнего слота, поэтому хватает одного прохода.
  */
-static inline void pool_return_node(IntHashSet *set, HashNode *node) {
-    node->next = set->pool;
-    set->pool = node;
+static void int_hashset_purge(IntHashSet *set) {
+    size_t start = 0;
+    while (set->keys[start] != 0) start++;
+
+    for (size_t i = 0; i < set->capacity; i++) {
+        if (set->keys[i] != 0 && !stamp_is_live(set, set->stamps[i])) {
+            set->keys[i] = 0;
+        }
+    }
+
+    set->used = 0;
+    for (size_t step = 1; step <= set->capacity; step++) {
+        size_t i = (start + step) & set->mask;
+        value_t key = set->keys[i];
+        if (key == 0) continue;
+
+        uint64_t stamp = set->stamps[i];
+        set->keys[i] = 0;
+        size_t slot = int_hashset_find_slot(set, key);
+        set->keys[slot] = key;
+        set->stamps[slot] = stamp;
+        set->used++;
+    }
 }
 
 /**
- * Изменение размера хеш-таблицы
+ * Перестроение таблицы: мертвые слоты выбрасываются, емкость растет,
+ * пока живые значения занимают больше половины допустимой загрузки.
+ * Без роста таблица перестраивается на месте, без выделения памяти.
  */
-static void int_hashset_resize(IntHashSet *set) {
-    size_t new_bucket_count = set->bucket_count * 2;
-    HashNode **new_buckets = calloc(new_bucket_count, sizeof(HashNode*));
+static void int_hashset_rebuild(IntHashSet *set) {
+    size_t capacity = set->capacity;
+    while ((double)(set->size + 1) * 2.0 > (double)capacity * LOAD_FACTOR_THRESHOLD) {
+        capacity *= 2;
+    }
 
-    // Перехешируем все элементы
-    for (size_t i = 0; i < set->bucket_count; i++) {
-        HashNode *node = set->buckets[i];
-        while (node) {
-            HashNode *next = node->next;
-            size_t new_index = int_hash(node->value, new_bucket_count);
-            node->next = new_buckets[new_index];
-            new_buckets[new_index] = node;
-            node = next;
+    if (capacity == set->capacity) {
+        int_hashset_purge(set);
+        return;
+    }
+
+    COUNT_HOT_ALLOCATION();
+    value_t *old_keys = set->keys;
+    uint64_t *old_stamps = set->stamps;
+    size_t old_capacity = set->capacity;
+
+    set->capacity = capacity;
+    set->mask = capacity - 1;
+    set->keys = int_hashset_alloc_keys(capacity);
+    set->stamps = malloc(capacity * sizeof(uint64_t));
+    set->used = 0;
+
+    // Переносим живые значения вместе с метками
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_keys[i] != 0 && stamp_is_live(set, old_stamps[i])) {
+            size_t slot = int_hashset_find_slot(set, old_keys[i]);
+            set->keys[slot] = old_keys[i];
+            set->stamps[slot] = old_stamps[i];
+            set->used++;
         }
     }
 
-    free(set->buckets);
-    set->buckets = new_buckets;
-    set->bucket_count = new_bucket_count;
+    free(old_keys);
+    free(old_stamps);
 }
 
-IntHashSet* int_hashset_create(size_t initial_buckets) {
+IntHashSet* int_hashset_create(size_t initial_capacity) {
     IntHashSet *set = malloc(sizeof(IntHashSet));
-    set->bucket_count = initial_buckets > 0 ? initial_buckets : INITIAL_BUCKET_COUNT;
-    set->buckets = calloc(set->bucket_count, sizeof(HashNode*));
-    set->pool = NULL;
-    set->size = 0;
+    size_t capacity = INT_HASHSET_GROUP;
+    size_t requested = initial_capacity > 0 ? initial_capacity : INITIAL_BUCKET_COUNT;
+    while (capacity < requested) capacity *= 2;
 
-    // Предаллокация пула для избежания malloc в горячем пути
-    int_hashset_prealloc_pool(set, POOL_PREALLOC_SIZE);
+    set->capacity = capacity;
+    set->mask = capacity - 1;
+    set->keys = int_hashset_alloc_keys(capacity);
+    set->stamps = malloc(capacity * sizeof(uint64_t));
 
+    int_hashset_clear(set);
     return set;
 }
 
 void int_hashset_destroy(IntHashSet *set) {
     if (!set) return;
-
-    // Очистка buckets
-    for (size_t i = 0; i < set->bucket_count; i++) {
-        HashNode *node = set->buckets[i];
-        while (node) {
-            HashNode *next = node->next;
-            free(node);
-            node = next;
-        }
-    }
-
-    // Очистка пула
-    HashNode *current = set->pool;
-    while (current) {
-        HashNode *next = current->next;
-        free(current);
-        current = next;
-    }
-
-    free(set->buckets);
+    free(set->keys);
+    free(set->stamps);
     free(set);
 }
 
 bool int_hashset_add(IntHashSet *set, value_t value) {
-    // Проверяем, есть ли уже такое значение
-    if (int_hashset_contains(set, value)) {
-        return false;
-    }
+    uint64_t stamp = set->level_stamp[set->depth];
 
-    // Проверяем необходимость изменения размера
-    if ((double)set->size / (double)set->bucket_count > LOAD_FACTOR_THRESHOLD) {
-        int_hashset_resize(set);
+    if (value == 0) {
+        if (stamp_is_live(set, set->zero_stamp)) return false;
+        set->zero_stamp = stamp;
+    } else {
+        size_t slot = int_hashset_find_slot(set, value);
+        if (set->keys[slot] == value) {
+            if (stamp_is_live(set, set->stamps[slot])) {
+                return false;
+            }
+            // Мертвый слот с тем же ключом оживает
+        } else {
+            // Проверяем необходимость перестроения
+            if ((double)(set->used + 1) > (double)set->capacity * LOAD_FACTOR_THRESHOLD) {
+                int_hashset_rebuild(set);
+                slot = int_hashset_find_slot(set, value);
+            }
+            set->keys[slot] = value;
+            set->used++;
+        }
+        set->stamps[slot] = stamp;
     }
 
-    // Добавляем новый узел
-    size_t index = int_hash(value, set->bucket_count);
-    HashNode *node = pool_get_node(set);
-    node->value = value;
-    node->next = set->buckets[index];
-    set->buckets[index] = node;
     set->size++;
-
+    set->level_size[set->depth]++;
     return true;
 }
 
 bool int_hashset_contains(const IntHashSet *set, value_t value) {
-    size_t index = int_hash(value, set->bucket_count);
-    HashNode *node = set->buckets[index];
+    if (value == 0) {
+        return stamp_is_live(set, set->zero_stamp);
+    }
+    size_t slot = int_hashset_find_slot(set, value);
+    return set->keys[slot] == value && stamp_is_live(set, set->stamps[slot]);
+}
 
-    while (node) {
-        if (node->value == value) {
-            return true;
-        }
-        node = node->next;
+bool int_hashset_remove(IntHashSet *set, value_t value) {
+    uint64_t *stamp;
+    if (value == 0) {
+        stamp = &set->zero_stamp;
+    } else {
+        size_t slot = int_hashset_find_slot(set, value);
+        if (set->keys[slot] != value) return false;
+        stamp = &set->stamps[slot];
     }
 
-    return false;
+    if (!stamp_is_live(set, *stamp)) {
+        return false;
+    }
+
+    // Слот остается занятым (мертвым) до перестроения
+    set->level_size[*stamp & 0xFF]--;
+    set->size--;
+    *stamp = 0;
+    return true;
 }
 
-bool int_hashset_remove(IntHashSet *set, value_t value) {
-    size_t index = int_hash(value, set->bucket_count);
-    HashNode *node = set->buckets[index];
-    HashNode *prev = NULL;
-
-    while (node) {
-        if (node->value == value) {
-            if (prev) {
-                prev->next = node->next;
-            } else {
-                set->buckets[index] = node->next;
-            }
-            // Возвращаем узел в пул
-            pool_return_node(set, node);
-            set->size--;
-            return true;
-        }
-        prev = node;
-        node = node->next;
+void int_hashset_push_level(IntHashSet *set) {
+    if (set->depth + 1 >= INT_HASHSET_MAX_LEVELS) {
+        LOG_ERROR("Превышено число уровней хеш-таблицы (%d)", INT_HASHSET_MAX_LEVELS);
+        abort();
     }
+    set->depth++;
+    set->level_stamp[set->depth] = (++set->next_id << 8) | set->depth;
+    set->level_size[set->depth] = 0;
+}
 
-    return false;
+void int_hashset_pop_level(IntHashSet *set) {
+    if (set->depth == 0) return;
+    set->size -= set->level_size[set->depth];
+    set->depth--;
 }
 
 void int_hashset_clear(IntHashSet *set) {
-    for (size_t i = 0; i < set->bucket_count; i++) {
-        HashNode *node = set->buckets[i];
-        while (node) {
-            HashNode *next = node->next;
-            pool_return_node(set, node);
-            node = next;
-        }
-        set->buckets[i] = NULL;
-    }
+    memset(set->keys, 0, set->capacity * sizeof(value_t));
     set->size = 0;
+    set->used = 0;
+    set->zero_stamp = 0;
+    set->next_id = 1;
+    set->depth = 0;
+    set->level_stamp[0] = 1ULL << 8;
+    set->level_size[0] = 0;
 }
 
 // ============================================================================
-// Реализация истории для отката
+// Реализация истории сумм
 // ============================================================================
 
 static void sums_history_init(SumsHistory *history, size_t capacity) {
@@ -211,59 +323,586 @@ static void sums_history_init(SumsHistory *history, size_t capacity) {
 }
 
 static void sums_history_clear(SumsHistory *history) {
-    if (history->sums) {
-        free(history->sums);
-        history->sums = NULL;
-    }
+    free(history->sums);
+    history->sums = NULL;
     history->count = 0;
     history->capacity = 0;
 }
 
-static inline void sums_history_add(SumsHistory *history, value_t value) {
-    if (history->count >= history->capacity) {
-        history->capacity *= 2;
+/**
+ * Гарантирует место под count значений
+ */
+static inline void sums_history_reserve(SumsHistory *history, size_t count) {
+    if (count > history->capacity) {
+        COUNT_HOT_ALLOCATION();
+        while (history->capacity < count) history->capacity *= 2;
         history->sums = realloc(history->sums, history->capacity * sizeof(value_t));
     }
-    history->sums[history->count++] = value;
 }
 
-static void history_stack_init(HistoryStack *stack, size_t capacity) {
-    stack->capacity = capacity > 0 ? capacity : 64;
-    stack->entries = malloc(stack->capacity * sizeof(SumsHistory));
-    for (size_t i = 0; i < stack->capacity; i++) {
-        sums_history_init(&stack->entries[i], 512);
+// ============================================================================
+// Реализация битовых слоев (битовый режим)
+// ============================================================================
+
+/**
+ * Слов слоя depth по границе: сумма depth различных элементов не больше
+ * max_value - max + (max - 1) + ... + (max - depth + 1).
+ * 0 - границы нет; не больше BITSET_MAX_LAYER_WORDS.
+ */
+static size_t bit_layer_bound_words(const BitLayers *bits, size_t depth) {
+    if (bits->max_value == 0) {
+        return 0;
+    }
+
+    value_t count = depth < bits->max_value ? (value_t)depth : bits->max_value;
+    value_t sum = count * bits->max_value - count * (count - 1) / 2;
+    value_t words = bits->span * sum / 64 + 1;
+    return words < BITSET_MAX_LAYER_WORDS ? (size_t)words : BITSET_MAX_LAYER_WORDS;
+}
+
+/**
+ * Стек слоев на layer_count глубин
+ * max_value * span * (layer_count - 1) не должно переполнять value_t
+ */
+static BitLayers* bit_layers_create(size_t layer_count, value_t max_value, value_t span) {
+    BitLayers *bits = malloc(sizeof(BitLayers));
+    bits->layer_count = layer_count > 0 ? layer_count : BITSET_DEFAULT_LAYERS;
+    bits->max_value = max_value;
+    bits->span = span;
+    bits->layers = calloc(bits->layer_count, sizeof(uint64_t*));
+    bits->layer_capacity = calloc(bits->layer_count, sizeof(size_t));
+
+    // Слой 0: только пустое подмножество (сумма 0); остальные выделяются
+    // при первом построении - мелкие деревья не занимают память под все N
+    bits->layers[0] = calloc(1, sizeof(uint64_t));
+    bits->layers[0][0] = 1;
+    bits->layer_capacity[0] = 1;
+    bits->built_depth = 0;
+
+    return bits;
+}
+
+static void bit_layers_destroy(BitLayers *bits) {
+    if (!bits) return;
+    for (size_t i = 0; i < bits->layer_count; i++) {
+        free(bits->layers[i]);
+    }
+    free(bits->layers);
+    free(bits->layer_capacity);
+    free(bits);
+}
+
+/**
+ * Гарантирует, что слой depth существует и вмещает words слов
+ */
+static uint64_t* bit_layers_ensure(BitLayers *bits, size_t depth, size_t words) {
+    if (depth >= bits->layer_count) {
+        COUNT_HOT_ALLOCATION();
+        size_t new_count = bits->layer_count * 2;
+        while (new_count <= depth) new_count *= 2;
+        bits->layers = realloc(bits->layers, new_count * sizeof(uint64_t*));
+        bits->layer_capacity = realloc(bits->layer_capacity, new_count * sizeof(size_t));
+        for (size_t i = bits->layer_count; i < new_count; i++) {
+            bits->layers[i] = NULL;
+            bits->layer_capacity[i] = 0;
+        }
+        bits->layer_count = new_count;
+    }
+
+    if (bits->layer_capacity[depth] < words) {
+        // Первое построение слоя в пределах границы - разовое выделение
+        // под всю границу, остальное - рост сверх рассчитанного
+        size_t bound = bit_layer_bound_words(bits, depth);
+        size_t capacity = bits->layer_capacity[depth];
+        if (capacity == 0 && words <= bound) {
+            capacity = bound;
+        } else {
+            COUNT_HOT_ALLOCATION();
+            if (capacity == 0) {
+                capacity = bound > BITSET_MIN_WORDS ? bound : BITSET_MIN_WORDS;
+            }
+            while (capacity < words) capacity *= 2;
+        }
+        free(bits->layers[depth]);
+        bits->layers[depth] = malloc(capacity * sizeof(uint64_t));
+        bits->layer_capacity[depth] = capacity;
+    }
+
+    return bits->layers[depth];
+}
+
+/**
+ * Проверка коллизии в битовом режиме: (S & (S << value)) != 0
+ * Бит s в S & (S << v) означает, что s и s - v - обе суммы,
+ * т.е. v равно разности двух сумм подмножеств.
+ */
+static bool bitset_has_collision(const SubsetSumManager *manager, value_t value) {
+    // v больше любой суммы - разность сумм не может быть равна v
+    if (value > manager->elements_sum) {
+        return false;
+    }
+
+    const uint64_t *sums = manager->bit_layers->layers[manager->elements.size];
+    size_t words = (size_t)(manager->elements_sum / 64) + 1;
+    size_t word_shift = (size_t)(value / 64);
+    unsigned bit_shift = (unsigned)(value % 64);
+
+    // Первое слово, в которое попадает сдвиг: младшие биты только из sums[0]
+    if (sums[word_shift] & (sums[0] << bit_shift)) {
+        return true;
+    }
+
+    if (bit_shift == 0) {
+        for (size_t i = word_shift + 1; i < words; i++) {
+            if (sums[i] & sums[i - word_shift]) {
+                return true;
+            }
+        }
+    } else {
+        unsigned back_shift = 64 - bit_shift;
+        for (size_t i = word_shift + 1; i < words; i++) {
+            uint64_t shifted = (sums[i - word_shift] << bit_shift) |
+                               (sums[i - word_shift - 1] >> back_shift);
+            if (sums[i] & shifted) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * dst |= src << shift
+ * src - words слов, dst должен вмещать (words * 64 + shift) бит
+ * либо dst_words слов, если старшие сдвинутые биты заведомо нулевые.
+ */
+static void bits_or_shifted(uint64_t *dst, size_t dst_words,
+                            const uint64_t *src, size_t words, value_t shift) {
+    size_t word_shift = (size_t)(shift / 64);
+    unsigned bit_shift = (unsigned)(shift % 64);
+
+    // Исходное слово j попадает в слова j + word_shift
+    // и (при ненулевом bit_shift) j + word_shift + 1
+    if (bit_shift == 0) {
+        for (size_t j = 0; j < words; j++) {
+            dst[j + word_shift] |= src[j];
+        }
+        return;
+    }
+
+    unsigned back_shift = 64 - bit_shift;
+    dst[word_shift] |= src[0] << bit_shift;
+    for (size_t j = 1; j < words; j++) {
+        dst[j + word_shift] |= (src[j] << bit_shift) | (src[j - 1] >> back_shift);
+    }
+    if (words + word_shift < dst_words) {
+        dst[words + word_shift] |= src[words - 1] >> back_shift;
+    }
+}
+
+/**
+ * Копирование слоя с обнулением хвоста до new_words слов
+ */
+static inline void bits_copy_layer(uint64_t *dst, size_t new_words,
+                                   const uint64_t *src, size_t words) {
+    memcpy(dst, src, words * sizeof(uint64_t));
+    if (new_words > words) {
+        memset(dst + words, 0, (new_words - words) * sizeof(uint64_t));
+    }
+}
+
+/**
+ * Построение слоя depth + 1: S' = S | (S << value)
+ * sum - сумма первых depth элементов
+ */
+static void bitset_add_sums(SubsetSumManager *manager, size_t depth,
+                            value_t sum, value_t value) {
+    size_t words = (size_t)(sum / 64) + 1;
+    size_t new_words = (size_t)((sum + value) / 64) + 1;
+
+    uint64_t *next = bit_layers_ensure(manager->bit_layers, depth + 1, new_words);
+    const uint64_t *sums = manager->bit_layers->layers[depth];
+
+    bits_copy_layer(next, new_words, sums, words);
+    bits_or_shifted(next, new_words, sums, words, value);
+}
+
+// ============================================================================
+// Реализация множества разностей (D-режим)
+// ============================================================================
+
+/**
+ * Слой k хранит T = {Σ ε_i a_i : ε_i ∈ {-1, 0, 1}} со смещением Σ_k:
+ * бит i соответствует t = i - Σ_k. Положительная часть T - это множество D
+ * положительных разностей сумм подмножеств, и v допустимо тогда и только
+ * тогда, когда v ∉ D.
+ */
+static inline bool dset_contains(const SubsetSumManager *manager, value_t value) {
+    // |t| <= Σ_k, большие значения заведомо не разности
+    if (value > manager->elements_sum) {
+        return false;
+    }
+    const uint64_t *diffs = manager->bit_layers->layers[manager->elements.size];
+    value_t bit = manager->elements_sum + value;
+    return (diffs[bit / 64] >> (bit % 64)) & 1;
+}
+
+/**
+ * Построение слоя depth + 1: T' = T ∪ (T + v) ∪ (T - v)
+ * Со смещением Σ' = Σ + v это три сдвига влево: L' = L | (L << v) | (L << 2v)
+ */
+static void dset_add_differences(SubsetSumManager *manager, size_t depth,
+                                 value_t sum, value_t value) {
+    size_t words = (size_t)(2 * sum / 64) + 1;
+    size_t new_words = (size_t)(2 * (sum + value) / 64) + 1;
+
+    uint64_t *next = bit_layers_ensure(manager->bit_layers, depth + 1, new_words);
+    const uint64_t *diffs = manager->bit_layers->layers[depth];
+
+    bits_copy_layer(next, new_words, diffs, words);
+    bits_or_shifted(next, new_words, diffs, words, value);
+    bits_or_shifted(next, new_words, diffs, words, 2 * value);
+}
+
+/**
+ * Наименьшее v >= from, v ∉ T (from >= 1)
+ * Биты выше 2Σ в последнем слове слоя нулевые, поэтому поиск всегда
+ * заканчивается не дальше Σ + 1.
+ */
+static value_t dset_next_allowed(const SubsetSumManager *manager, value_t from) {
+    value_t sum = manager->elements_sum;
+    if (from > sum) {
+        return from;
+    }
+
+    const uint64_t *diffs = manager->bit_layers->layers[manager->elements.size];
+    size_t words = (size_t)(2 * sum / 64) + 1;
+    value_t bit = sum + from;
+    size_t index = (size_t)(bit / 64);
+
+    // Первое слово: маскируем биты ниже from
+    uint64_t free_bits = ~diffs[index] & (~0ULL << (bit % 64));
+    while (free_bits == 0) {
+        if (++index >= words) {
+            return sum + 1;
+        }
+        free_bits = ~diffs[index];
+    }
+
+    return (value_t)index * 64 + (value_t)__builtin_ctzll(free_bits) - sum;
+}
+
+/**
+ * Наибольшее v из [floor, from], v ∉ T (floor >= 1), 0 - такого нет
+ */
+static value_t dset_prev_allowed(const SubsetSumManager *manager, value_t from,
+                                 value_t floor) {
+    value_t sum = manager->elements_sum;
+    if (from > sum) {
+        return from;
+    }
+
+    const uint64_t *diffs = manager->bit_layers->layers[manager->elements.size];
+    value_t bit = sum + from;
+    size_t index = (size_t)(bit / 64);
+    size_t low_index = (size_t)((sum + floor) / 64);
+
+    // Первое слово: маскируем биты выше from
+    uint64_t mask = bit % 64 == 63 ? ~0ULL : (1ULL << (bit % 64 + 1)) - 1;
+    uint64_t free_bits = ~diffs[index] & mask;
+    while (free_bits == 0) {
+        if (index == low_index) {
+            return 0;
+        }
+        free_bits = ~diffs[--index];
+    }
+
+    // Свободный бит ниже floor (в том числе отрицательные t) - кандидата нет
+    value_t found = (value_t)index * 64 + 63 - (value_t)__builtin_clzll(free_bits);
+    return found >= sum + floor ? found - sum : 0;
+}
+
+/**
+ * Ленивое построение слоя текущей глубины
+ * Слой строится только при первом обращении к нему: для листьев поиска
+ * (последний элемент множества) слой не нужен и не строится вовсе.
+ * Каждое добавление предваряется проверкой, поэтому отставание не больше 1.
+ */
+static inline void bit_layers_sync(SubsetSumManager *manager) {
+    BitLayers *bits = manager->bit_layers;
+    size_t depth = bits->built_depth;
+    if (depth == manager->elements.size) {
+        return;
+    }
+
+    value_t value = manager->elements.elements[depth];
+    value_t sum = manager->elements_sum - value;
+    if (manager->type == MANAGER_TYPE_DSET) {
+        dset_add_differences(manager, depth, sum, value);
+    } else {
+        bitset_add_sums(manager, depth, sum, value);
+    }
+    bits->built_depth = depth + 1;
+}
+
+// ============================================================================
+// Реализация отсортированных сумм (отсортированный режим)
+// ============================================================================
+
+static inline size_t sorted_layer_offset(size_t depth) {
+    return ((size_t)1 << depth) - 1;
+}
+
+static SortedSums* sorted_sums_create(uint32_t max_elements) {
+    SortedSums *sorted = malloc(sizeof(SortedSums));
+
+    // Все слои до глубины max_elements (2^(max_elements + 1) - 1 значений)
+    // только для небольших N, иначе массив растет при слиянии
+    size_t depth = max_elements > 0 && max_elements <= PRESIZE_MAX_ELEMENTS ?
+                   max_elements : SORTED_DEFAULT_DEPTH;
+    sorted->capacity = sorted_layer_offset(depth + 1);
+    sorted->sums = malloc(sorted->capacity * sizeof(value_t));
+    if (!sorted->sums) {
+        LOG_ERROR("Отсортированный режим: не удалось выделить %zu сумм", sorted->capacity);
+        sorted->capacity = 0;
+        return sorted;
+    }
+
+    // Слой 0: только пустое подмножество
+    sorted->sums[0] = 0;
+
+    return sorted;
+}
+
+static void sorted_sums_destroy(SortedSums *sorted) {
+    if (!sorted) return;
+    free(sorted->sums);
+    free(sorted);
+}
+
+/**
+ * Слияние sums_k и sums_k + value в слой k+1 с проверкой коллизий
+ * Обе последовательности отсортированы, поэтому равные суммы окажутся
+ * рядом при слиянии двумя указателями. При коллизии возвращает false,
+ * слой k+1 при этом остается недостроенным (он не используется).
+ * Если массив не удалось расширить - тоже false и out_of_memory.
+ */
+static bool sorted_merge_sums(SubsetSumManager *manager, value_t value) {
+    size_t depth = manager->elements.size;
+    size_t count = (size_t)1 << depth;
+    size_t needed = sorted_layer_offset(depth + 2);
+
+    SortedSums *sorted = manager->sorted_sums;
+    if (sorted->capacity < needed) {
+        COUNT_HOT_ALLOCATION();
+        value_t *sums = realloc(sorted->sums, needed * sizeof(value_t));
+        if (!sums) {
+            LOG_ERROR("Отсортированный режим: не удалось выделить %zu сумм", needed);
+            manager->out_of_memory = true;
+            return false;
+        }
+        if (sorted->capacity == 0) {
+            sums[0] = 0;
+        }
+        sorted->sums = sums;
+        sorted->capacity = needed;
+    }
+
+    const value_t *src = sorted->sums + sorted_layer_offset(depth);
+    value_t *dst = sorted->sums + sorted_layer_offset(depth + 1);
+
+    size_t i = 0;
+    size_t j = 0;
+    while (i < count && j < count) {
+        value_t a = src[i];
+        value_t b = src[j] + value;
+        if (a < b) {
+            *dst++ = a;
+            i++;
+        } else if (a > b) {
+            *dst++ = b;
+            j++;
+        } else {
+            return false;
+        }
+    }
+
+    // Хвосты больше всех элементов другой последовательности - коллизий нет
+    while (i < count) {
+        *dst++ = src[i++];
+    }
+    while (j < count) {
+        *dst++ = src[j++] + value;
+    }
+
+    return true;
+}
+
+// ============================================================================
+// Реализация встречи посередине (MITM-режим)
+// ============================================================================
+
+#define MITM_INITIAL_LAYERS 32
+#define MITM_INITIAL_VALUES 4096
+
+static void signed_half_init(SignedSumsHalf *half, size_t initial_values) {
+    half->capacity = initial_values > MITM_INITIAL_VALUES ? initial_values : MITM_INITIAL_VALUES;
+    half->values = malloc(half->capacity * sizeof(int64_t));
+    half->layer_capacity = MITM_INITIAL_LAYERS;
+    half->layer_offset = malloc(half->layer_capacity * sizeof(size_t));
+    half->layer_size = malloc(half->layer_capacity * sizeof(size_t));
+
+    // Слой 0: только пустая сумма
+    half->values[0] = 0;
+    half->layer_offset[0] = 0;
+    half->layer_size[0] = 1;
+    half->built = 0;
+}
+
+static void signed_half_clear(SignedSumsHalf *half) {
+    free(half->values);
+    free(half->layer_offset);
+    free(half->layer_size);
+}
+
+/**
+ * Построение слоя m + 1: слияние (T - v), T и (T + v) без повторов
+ * Все три последовательности отсортированы, поэтому слияние линейно.
+ */
+static void signed_half_push(SignedSumsHalf *half, value_t value) {
+    size_t m = half->built;
+    size_t size = half->layer_size[m];
+    size_t offset = half->layer_offset[m] + size;
+    size_t needed = offset + 3 * size;
+
+    if (m + 1 >= half->layer_capacity) {
+        COUNT_HOT_ALLOCATION();
+        half->layer_capacity *= 2;
+        half->layer_offset = realloc(half->layer_offset, half->layer_capacity * sizeof(size_t));
+        half->layer_size = realloc(half->layer_size, half->layer_capacity * sizeof(size_t));
+    }
+    if (needed > half->capacity) {
+        COUNT_HOT_ALLOCATION();
+        while (half->capacity < needed) half->capacity *= 2;
+        half->values = realloc(half->values, half->capacity * sizeof(int64_t));
+    }
+
+    const int64_t *src = half->values + half->layer_offset[m];
+    int64_t *dst = half->values + offset;
+    int64_t v = (int64_t)value;
+
+    size_t i = 0;   // src - v
+    size_t j = 0;   // src
+    size_t k = 0;   // src + v
+    size_t out = 0;
+    while (k < size) {
+        int64_t a = i < size ? src[i] - v : INT64_MAX;
+        int64_t b = j < size ? src[j] : INT64_MAX;
+        int64_t c = src[k] + v;
+
+        int64_t smallest = a < b ? a : b;
+        if (c < smallest) smallest = c;
+
+        if (out == 0 || dst[out - 1] != smallest) {
+            dst[out++] = smallest;
+        }
+        if (a == smallest) i++;
+        if (b == smallest) j++;
+        if (c == smallest) k++;
+    }
+
+    half->layer_offset[m + 1] = offset;
+    half->layer_size[m + 1] = out;
+    half->built = m + 1;
+}
+
+static MeetInMiddle* mitm_create(uint32_t max_elements) {
+    MeetInMiddle *mitm = malloc(sizeof(MeetInMiddle));
+
+    // Верхний слой половины - до 3^(N/2) значений
+    size_t initial_values = MITM_INITIAL_VALUES;
+    if (max_elements > 0 && max_elements <= 24) {
+        initial_values = 1;
+        for (uint32_t i = 0; i < (max_elements + 1) / 2; i++) initial_values *= 3;
+        initial_values *= 2;
     }
-    stack->count = 0;
+
+    signed_half_init(&mitm->halves[0], initial_values);
+    signed_half_init(&mitm->halves[1], initial_values);
+    return mitm;
+}
+
+static void mitm_destroy(MeetInMiddle *mitm) {
+    if (!mitm) return;
+    signed_half_clear(&mitm->halves[0]);
+    signed_half_clear(&mitm->halves[1]);
+    free(mitm);
 }
 
-static void history_stack_clear(HistoryStack *stack) {
-    if (stack->entries) {
-        for (size_t i = 0; i < stack->capacity; i++) {
-            sums_history_clear(&stack->entries[i]);
+/**
+ * Ленивое построение слоев обеих половин под текущее множество
+ */
+static void mitm_sync(SubsetSumManager *manager) {
+    size_t n = manager->elements.size;
+    for (size_t h = 0; h < 2; h++) {
+        SignedSumsHalf *half = &manager->mitm->halves[h];
+        size_t target = (n + 1 - h) / 2;
+        while (half->built < target) {
+            signed_half_push(half, manager->elements.elements[2 * half->built + h]);
         }
-        free(stack->entries);
-        stack->entries = NULL;
     }
-    stack->count = 0;
-    stack->capacity = 0;
 }
 
-static SumsHistory* history_stack_push(HistoryStack *stack) {
-    if (stack->count >= stack->capacity) {
-        size_t new_capacity = stack->capacity * 2;
-        stack->entries = realloc(stack->entries, new_capacity * sizeof(SumsHistory));
-        for (size_t i = stack->capacity; i < new_capacity; i++) {
-            sums_history_init(&stack->entries[i], 512);
+/**
+ * v дает коллизию iff v = x + y, x и y - знаковые суммы левой и правой половин
+ * (тогда v ∈ T всего множества). Левая половина - по возрастанию,
+ * правая - по убыванию, два указателя.
+ */
+static bool mitm_has_collision(SubsetSumManager *manager, value_t value) {
+    if (value > manager->elements_sum) {
+        return false;
+    }
+
+    mitm_sync(manager);
+
+    const SignedSumsHalf *left = &manager->mitm->halves[0];
+    const SignedSumsHalf *right = &manager->mitm->halves[1];
+    const int64_t *xs = left->values + left->layer_offset[left->built];
+    const int64_t *ys = right->values + right->layer_offset[right->built];
+    size_t x_count = left->layer_size[left->built];
+    size_t y_count = right->layer_size[right->built];
+    int64_t target = (int64_t)value;
+
+    size_t i = 0;
+    size_t j = y_count;
+    while (i < x_count && j > 0) {
+        int64_t sum = xs[i] + ys[j - 1];
+        if (sum == target) {
+            return true;
+        }
+        if (sum < target) {
+            i++;
+        } else {
+            j--;
         }
-        stack->capacity = new_capacity;
     }
-    stack->entries[stack->count].count = 0;
-    return &stack->entries[stack->count++];
+
+    return false;
 }
 
-static SumsHistory* history_stack_pop(HistoryStack *stack) {
-    if (stack->count == 0) return NULL;
-    return &stack->entries[--stack->count];
+/**
+ * Откат слоев половин после удаления элемента
+ */
+static inline void mitm_truncate(SubsetSumManager *manager) {
+    size_t n = manager->elements.size;
+    for (size_t h = 0; h < 2; h++) {
+        SignedSumsHalf *half = &manager->mitm->halves[h];
+        size_t target = (n + 1 - h) / 2;
+        if (half->built > target) {
+            half->built = target;
+        }
+    }
 }
 
 // ============================================================================
@@ -271,19 +910,71 @@ static SumsHistory* history_stack_pop(HistoryStack *stack) {
 // ============================================================================
 
 SubsetSumManager* subset_sum_manager_create(ManagerType type) {
+    return subset_sum_manager_create_bounded(type, 0, 0);
+}
+
+SubsetSumManager* subset_sum_manager_create_bounded(ManagerType type,
+                                                    uint32_t max_elements,
+                                                    value_t max_value) {
     SubsetSumManager *manager = malloc(sizeof(SubsetSumManager));
     manager->type = type;
 
-    number_set_init(&manager->elements, 64);
+    number_set_init(&manager->elements, max_elements > 0 ? max_elements : 64);
     manager->temp_sum = 0;
+    manager->elements_sum = 0;
+
+    manager->sums_set = NULL;
+    manager->history = NULL;
+    manager->bit_layers = NULL;
+    manager->sorted_sums = NULL;
+    manager->iterative = NULL;
+    manager->mitm = NULL;
+    manager->presized = false;
+    manager->out_of_memory = false;
 
     if (type == MANAGER_TYPE_FAST) {
-        manager->sums_set = int_hashset_create(INITIAL_BUCKET_COUNT);
-        manager->history = malloc(sizeof(HistoryStack));
-        history_stack_init(manager->history, 64);
-    } else {
-        manager->sums_set = NULL;
-        manager->history = NULL;
+        // 2^max_elements - 1 сумм: история целиком, таблица - с запасом
+        // вдвое против порога перестроения, чтобы она не росла
+        size_t max_sums = INITIAL_BUCKET_COUNT;
+        if (max_elements > 0 && max_elements <= PRESIZE_MAX_ELEMENTS) {
+            max_sums = (size_t)1 << max_elements;
+        }
+        manager->sums_set = int_hashset_create(max_sums > INITIAL_BUCKET_COUNT / 4 ?
+                                               4 * max_sums : INITIAL_BUCKET_COUNT);
+        manager->history = malloc(sizeof(SumsHistory));
+        sums_history_init(manager->history, max_sums);
+        manager->presized = max_elements > 0 && max_elements <= PRESIZE_MAX_ELEMENTS;
+    } else if (type == MANAGER_TYPE_BITSET || type == MANAGER_TYPE_DSET) {
+        // Слой k - по границе суммы k элементов не больше max_value,
+        // D-режим хранит отрезок [-Σ, Σ] - вдвое больше бит
+        value_t span = type == MANAGER_TYPE_DSET ? 2 : 1;
+        value_t bound = 0;
+        if (max_elements > 0 && max_value > 0 && max_value < VALUE_MAX / max_elements / 2) {
+            bound = max_value;
+        }
+        manager->bit_layers = bit_layers_create((size_t)max_elements + 1, bound, span);
+        manager->presized = bound > 0 &&
+                            bit_layer_bound_words(manager->bit_layers, max_elements) <
+                            BITSET_MAX_LAYER_WORDS;
+    } else if (type == MANAGER_TYPE_SORTED) {
+        manager->sorted_sums = sorted_sums_create(max_elements);
+        manager->presized = max_elements > 0 && max_elements <= PRESIZE_MAX_ELEMENTS;
+        manager->out_of_memory = manager->sorted_sums->capacity == 0;
+    } else if (type == MANAGER_TYPE_MITM) {
+        manager->mitm = mitm_create(max_elements);
+        manager->presized = max_elements > 0 && max_elements <= 24;
+    } else if (type == MANAGER_TYPE_ITERATIVE) {
+        manager->iterative = calloc(1, sizeof(IterativeScratch));
+        manager->iterative->sorted_size = SIZE_MAX;
+
+        // Проверяется множество не больше чем из max_elements - 1 элементов
+        if (max_elements > 0 && max_elements <= PRESIZE_MAX_ELEMENTS) {
+            size_t count = (size_t)1 << (max_elements - 1);
+            manager->iterative->sums = malloc(count * sizeof(value_t));
+            manager->iterative->buffer = malloc(count * sizeof(value_t));
+            manager->iterative->capacity = count;
+            manager->presized = true;
+        }
     }
 
     return manager;
@@ -299,15 +990,38 @@ void subset_sum_manager_destroy(SubsetSumManager *manager) {
     }
 
     if (manager->history) {
-        history_stack_clear(manager->history);
+        sums_history_clear(manager->history);
         free(manager->history);
     }
 
+    bit_layers_destroy(manager->bit_layers);
+    sorted_sums_destroy(manager->sorted_sums);
+    mitm_destroy(manager->mitm);
+
+    if (manager->iterative) {
+        free(manager->iterative->sums);
+        free(manager->iterative->buffer);
+        free(manager->iterative);
+    }
+
     free(manager);
 }
 
 void subset_sum_manager_reset(SubsetSumManager *manager) {
     manager->elements.size = 0;
+    manager->elements_sum = 0;
+
+    if (manager->bit_layers) {
+        manager->bit_layers->built_depth = 0;
+    }
+
+    if (manager->iterative) {
+        manager->iterative->sorted_size = SIZE_MAX;
+    }
+
+    if (manager->mitm) {
+        mitm_truncate(manager);
+    }
 
     if (manager->type == MANAGER_TYPE_FAST) {
         int_hashset_clear(manager->sums_set);
@@ -319,66 +1033,125 @@ void subset_sum_manager_reset(SubsetSumManager *manager) {
  * Вычисление новых сумм при добавлении элемента (быстрый режим)
  * new_sums = {value} ∪ {value + s | s ∈ current_sums}
  *
- * Оптимизация: сначала собираем все текущие суммы в массив,
- * затем проверяем все коллизии, и только потом добавляем.
+ * Новые суммы попарно различны (value + s_i = value + s_j только при
+ * s_i = s_j) и не равны value, поэтому каждая сразу добавляется на уровень
+ * нового элемента; при коллизии уровень закрывается за O(1).
  */
-static bool compute_and_add_sums_fast(SubsetSumManager *manager, value_t value,
-                                       SumsHistory *new_sums_history) {
-    // Проверяем само значение на коллизию
-    if (int_hashset_contains(manager->sums_set, value)) {
-        return false;
-    }
+static bool compute_and_add_sums_fast(SubsetSumManager *manager, value_t value) {
+    IntHashSet *set = manager->sums_set;
+    SumsHistory *history = manager->history;
+    size_t current_count = history->count;
 
-    size_t current_count = manager->sums_set->size;
+    sums_history_reserve(history, 2 * current_count + 1);
+    value_t *new_sums = history->sums + current_count;
 
-    // Собираем текущие суммы в массив (нужно, т.к. будем модифицировать set)
-    value_t *current_sums = NULL;
-    if (current_count > 0) {
-        current_sums = malloc(current_count * sizeof(value_t));
-        size_t idx = 0;
-        for (size_t i = 0; i < manager->sums_set->bucket_count && idx < current_count; i++) {
-            HashNode *node = manager->sums_set->buckets[i];
-            while (node && idx < current_count) {
-                current_sums[idx++] = node->value;
-                node = node->next;
-            }
-        }
+    int_hashset_push_level(set);
+
+    if (!int_hashset_add(set, value)) {
+        int_hashset_pop_level(set);
+        return false;
     }
+    new_sums[0] = value;
 
-    // Проверяем коллизии для всех новых сумм
     for (size_t i = 0; i < current_count; i++) {
-        value_t new_sum = value + current_sums[i];
-        if (int_hashset_contains(manager->sums_set, new_sum)) {
-            free(current_sums);
+        value_t new_sum = value + history->sums[i];
+        if (!int_hashset_add(set, new_sum)) {
+            int_hashset_pop_level(set);
             return false;
         }
+        new_sums[i + 1] = new_sum;
     }
 
-    // Проверяем коллизии между новыми суммами
-    // (value + sum_i) == (value + sum_j) невозможно при разных sum_i, sum_j
-    // Но нужно проверить value == (value + sum_i) - невозможно при sum_i > 0
-    // И (value + sum_i) == value - тоже невозможно
+    history->count = 2 * current_count + 1;
+    return true;
+}
+
+/**
+ * Поразрядная (LSD) сортировка сумм, 11 бит за проход
+ * Число проходов определяется max_value, для n <= 28 их не больше трех.
+ */
+static void radix_sort_values(value_t *values, value_t *scratch, size_t count,
+                              value_t max_value) {
+    enum { RADIX_BITS = 11, RADIX_SIZE = 1 << RADIX_BITS };
+    size_t counts[RADIX_SIZE];
+
+    value_t *src = values;
+    value_t *dst = scratch;
+    for (unsigned shift = 0; shift < 64 && (max_value >> shift) != 0; shift += RADIX_BITS) {
+        memset(counts, 0, sizeof(counts));
+        for (size_t i = 0; i < count; i++) {
+            counts[(src[i] >> shift) & (RADIX_SIZE - 1)]++;
+        }
 
-    // Коллизий нет — добавляем все новые суммы
+        size_t offset = 0;
+        for (size_t d = 0; d < RADIX_SIZE; d++) {
+            size_t c = counts[d];
+            counts[d] = offset;
+            offset += c;
+        }
 
-    // Добавляем само значение
-    int_hashset_add(manager->sums_set, value);
-    sums_history_add(new_sums_history, value);
+        for (size_t i = 0; i < count; i++) {
+            dst[counts[(src[i] >> shift) & (RADIX_SIZE - 1)]++] = src[i];
+        }
 
-    // Добавляем value + каждая существующая сумма
-    for (size_t i = 0; i < current_count; i++) {
-        value_t new_sum = value + current_sums[i];
-        int_hashset_add(manager->sums_set, new_sum);
-        sums_history_add(new_sums_history, new_sum);
+        value_t *tmp = src;
+        src = dst;
+        dst = tmp;
     }
 
-    free(current_sums);
-    return true;
+    if (src != values) {
+        memcpy(values, src, count * sizeof(value_t));
+    }
+}
+
+/**
+ * Построение отсортированных сумм всех 2^N подмножеств текущих элементов
+ * Суммы перечисляются кодом Грея: соседние подмножества отличаются одним
+ * элементом, поэтому каждая следующая сумма - одно сложение или вычитание.
+ * Результат кешируется до изменения множества.
+ */
+static void iterative_build_sums(SubsetSumManager *manager) {
+    IterativeScratch *scratch = manager->iterative;
+    size_t n = manager->elements.size;
+    size_t count = (size_t)1 << n;
+
+    if (scratch->capacity < count) {
+        COUNT_HOT_ALLOCATION();
+        free(scratch->sums);
+        free(scratch->buffer);
+        scratch->sums = malloc(count * sizeof(value_t));
+        scratch->buffer = malloc(count * sizeof(value_t));
+        scratch->capacity = count;
+    }
+
+    const value_t *elements = manager->elements.elements;
+    value_t *sums = scratch->sums;
+    value_t sum = 0;
+    uint64_t gray = 0;
+
+    sums[0] = 0;
+    for (size_t i = 1; i < count; i++) {
+        unsigned bit = (unsigned)__builtin_ctzll(i);
+        uint64_t mask = 1ULL << bit;
+        if (gray & mask) {
+            sum -= elements[bit];
+        } else {
+            sum += elements[bit];
+        }
+        gray ^= mask;
+        sums[i] = sum;
+    }
+
+    radix_sort_values(sums, scratch->buffer, count, manager->elements_sum);
+    scratch->sorted_size = n;
 }
 
 /**
  * Итеративная проверка коллизий
- * Перебирает все 2^N подмножеств текущих элементов
+ * v дает коллизию тогда и только тогда, когда v = s2 - s1 для двух сумм
+ * подмножеств текущих элементов. Суммы строятся кодом Грея и сортируются
+ * за O(2^N) один раз на узел поиска, каждый кандидат - один проход
+ * двумя указателями по отсортированному массиву.
  */
 bool subset_sum_manager_has_collision_iterative(SubsetSumManager *manager,
                                                 value_t new_value) {
@@ -394,46 +1167,30 @@ bool subset_sum_manager_has_collision_iterative(SubsetSumManager *manager,
         return true;  // Безопасный отказ
     }
 
-    uint64_t total_subsets = (1ULL << n);
-
-    // Проверка 1: new_value равно какой-то существующей сумме подмножества
-    for (uint64_t mask = 1; mask < total_subsets; mask++) {
-        value_t sum = 0;
-        for (size_t i = 0; i < n; i++) {
-            if (mask & (1ULL << i)) {
-                sum += manager->elements.elements[i];
-            }
-        }
-        if (sum == new_value) {
-            return true;
-        }
+    // v больше любой суммы - разность сумм не может быть равна v
+    if (new_value > manager->elements_sum) {
+        return false;
     }
 
-    // Проверка 2: {new_value} ∪ A и B имеют равные суммы
-    // То есть new_value + sum(A) == sum(B), где A и B - непересекающиеся подмножества
-    for (uint64_t mask1 = 0; mask1 < total_subsets; mask1++) {
-        value_t sum1 = new_value;
-        for (size_t i = 0; i < n; i++) {
-            if (mask1 & (1ULL << i)) {
-                sum1 += manager->elements.elements[i];
-            }
-        }
-
-        // Ищем подмножество B, не пересекающееся с A, с такой же суммой
-        for (uint64_t mask2 = 1; mask2 < total_subsets; mask2++) {
-            // Пропускаем пересекающиеся множества
-            if (mask1 & mask2) continue;
+    if (manager->iterative->sorted_size != n) {
+        iterative_build_sums(manager);
+    }
 
-            value_t sum2 = 0;
-            for (size_t i = 0; i < n; i++) {
-                if (mask2 & (1ULL << i)) {
-                    sum2 += manager->elements.elements[i];
-                }
-            }
+    const value_t *sums = manager->iterative->sums;
+    size_t count = (size_t)1 << n;
 
-            if (sum1 == sum2) {
-                return true;
-            }
+    // Ищем пару sums[j] - sums[i] == new_value
+    size_t j = 0;
+    for (size_t i = 0; i < count; i++) {
+        value_t target = sums[i] + new_value;
+        if (target > sums[count - 1]) {
+            break;
+        }
+        while (sums[j] < target) {
+            j++;
+        }
+        if (sums[j] == target) {
+            return true;
         }
     }
 
@@ -443,45 +1200,121 @@ bool subset_sum_manager_has_collision_iterative(SubsetSumManager *manager,
 bool subset_sum_manager_add_element(SubsetSumManager *manager, value_t value) {
     if (manager->type == MANAGER_TYPE_FAST) {
         // Быстрый режим: используем хеш-таблицу
-        SumsHistory *history = history_stack_push(manager->history);
+        if (!compute_and_add_sums_fast(manager, value)) {
+            return false;
+        }
 
-        if (!compute_and_add_sums_fast(manager, value, history)) {
-            // Коллизия - откатываем историю
-            history_stack_pop(manager->history);
+    } else if (manager->type == MANAGER_TYPE_BITSET) {
+        // Битовый режим: проверка сдвигом по словам, слой строится лениво
+        bit_layers_sync(manager);
+        if (bitset_has_collision(manager, value)) {
             return false;
         }
 
-        // Добавляем элемент в множество
-        number_set_push(&manager->elements, value);
-        return true;
+    } else if (manager->type == MANAGER_TYPE_DSET) {
+        // D-режим: одна проверка бита, слой строится лениво и только для принятых
+        bit_layers_sync(manager);
+        if (dset_contains(manager, value)) {
+            return false;
+        }
+
+    } else if (manager->type == MANAGER_TYPE_MITM) {
+        // Встреча посередине: слои половин строятся лениво
+        if (mitm_has_collision(manager, value)) {
+            return false;
+        }
+
+    } else if (manager->type == MANAGER_TYPE_SORTED) {
+        // Отсортированный режим: слияние с проверкой коллизий
+        if (!sorted_merge_sums(manager, value)) {
+            return false;
+        }
 
     } else {
         // Итеративный режим: проверяем коллизии перебором
         if (subset_sum_manager_has_collision_iterative(manager, value)) {
             return false;
         }
+    }
 
-        // Добавляем элемент
-        number_set_push(&manager->elements, value);
-        return true;
+    // Добавляем элемент в множество
+    number_set_push(&manager->elements, value);
+    manager->elements_sum += value;
+    return true;
+}
+
+value_t subset_sum_manager_next_candidate(SubsetSumManager *manager,
+                                          value_t from, value_t limit) {
+    if (from >= limit) {
+        return limit;
+    }
+
+    if (manager->type != MANAGER_TYPE_DSET) {
+        return from;
     }
+
+    bit_layers_sync(manager);
+    value_t next = dset_next_allowed(manager, from);
+    return next < limit ? next : limit;
+}
+
+bool subset_sum_manager_state_hash(SubsetSumManager *manager, uint64_t *hash) {
+    if (manager->type != MANAGER_TYPE_DSET) {
+        return false;
+    }
+
+    bit_layers_sync(manager);
+    const uint64_t *diffs = manager->bit_layers->layers[manager->elements.size];
+    size_t words = (size_t)(2 * manager->elements_sum / 64) + 1;
+
+    uint64_t h = manager->elements_sum;
+    for (size_t i = 0; i < words; i++) {
+        h = (h ^ diffs[i]) * 0xff51afd7ed558ccdULL;
+        h ^= h >> 32;
+    }
+    *hash = h;
+    return true;
+}
+
+value_t subset_sum_manager_prev_candidate(SubsetSumManager *manager,
+                                          value_t from, value_t floor) {
+    if (from < floor) {
+        return 0;
+    }
+
+    if (manager->type != MANAGER_TYPE_DSET) {
+        return from;
+    }
+
+    bit_layers_sync(manager);
+    return dset_prev_allowed(manager, from, floor);
 }
 
 void subset_sum_manager_remove_last(SubsetSumManager *manager) {
     if (manager->elements.size == 0) return;
 
     if (manager->type == MANAGER_TYPE_FAST) {
-        // Откатываем добавленные суммы из истории
-        SumsHistory *history = history_stack_pop(manager->history);
-        if (history) {
-            for (size_t i = 0; i < history->count; i++) {
-                int_hashset_remove(manager->sums_set, history->sums[i]);
-            }
-        }
+        // Закрываем уровень элемента и отрезаем его суммы
+        int_hashset_pop_level(manager->sums_set);
+        manager->history->count /= 2;
     }
 
-    // Удаляем последний элемент
+    // Удаляем последний элемент (слои битового режима просто перезапишутся)
+    manager->elements_sum -= manager->elements.elements[manager->elements.size - 1];
     number_set_pop(&manager->elements);
+
+    if (manager->bit_layers && manager->bit_layers->built_depth > manager->elements.size) {
+        manager->bit_layers->built_depth = manager->elements.size;
+    }
+
+    if (manager->mitm) {
+        mitm_truncate(manager);
+    }
+
+    // Кеш сумм итеративного режима построен для удаленного префикса
+    if (manager->iterative && manager->iterative->sorted_size > manager->elements.size) {
+        manager->iterative->sorted_size = SIZE_MAX;
+    }
 }
 
 size_t subset_sum_manager_size(const SubsetSumManager *manager) {